@@ -1,52 +1,281 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <vector>
 #include <array>
 #include <string>
+#include <cstdlib>
 #include <queue>
-#include <unordered_set>
 #include <unordered_map>
+#include <map>
 #include <algorithm>
 #include <utility>
 #include <tuple>
 #include <cmath>
+#include <cstdint>
+#include <climits>
+#include <memory>
+#include <cstring>
+#include <cerrno>
+#include <sys/mman.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <list>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <sys/resource.h>
+#include <type_traits>
+#include <condition_variable>
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 using namespace std;
 
 
                                                                                       /* =============================================== CONSTANTS =============================================== */
-const int N = 3; // size of the board (the board's dimension)
-const int NN = 9; // total count of cells on the board
+// the board's dimension N is a template parameter of everything that touches a board --- 3x3, 4x4 and 5x5 are instantiated and picked at runtime from the input
+const int MIN_BOARD_SIZE = 3;
+const int MAX_BOARD_SIZE = 5;
+const uint32_t NO_NODE = UINT32_MAX; // node id meaning "no node" (the root's parent, or a search that found nothing)
+const int EXIT_UNSOLVABLE = 2; // process exit code when the goal cannot be reached from the start (1 is reserved for usage/input errors)
+const int EXIT_OUT_OF_MEMORY = 3; // process exit code when the search ran out of its --memory budget before finding the goal
+
+// pattern database (h3) layout --- see the PATTERN DATABASE section (3x3 boards only)
+const int PDB_CELLS = 9;
+const int PDB_ENTRIES_PER_BLANK = 20160; // 8!/2 --- arrangements of the 8 tiles for one blank cell that are reachable from a goal
+const int PDB_ENTRIES_PER_GOAL = PDB_CELLS * PDB_ENTRIES_PER_BLANK; // 181440 = 9!/2 --- every state reachable from one goal
+const char PDB_MAGIC[8] = {'8', 'P', 'U', 'Z', 'P', 'D', 'B', '1'}; // first bytes of a pattern database file
+const char CACHE_MAGIC[8] = {'8', 'P', 'U', 'Z', 'R', 'C', 'H', '1'}; // first bytes of a result cache file
+
+enum search_kind{ // which search engine solves a puzzle
+    SEARCH_A_STAR, // A* graph search --- the default
+    SEARCH_IDA_STAR, // iterative-deepening A* --- memory grows only with the solution depth
+    SEARCH_BIDIRECTIONAL, // MM bidirectional search --- meets in the middle, each side only searches about half the depth
+    SEARCH_ORACLE, // no search: walks the exact distances of the pattern database straight to the goal (3x3 only)
+    SEARCH_HDA_STAR // hash-distributed A*: one puzzle, expanded by several threads that each own a slice of the state space
+};
+
+enum trace_output_kind{ // whether and how the per-solve trace is printed after the output
+    TRACE_OFF,
+    TRACE_TEXT,
+    TRACE_JSON
+};
+
+enum frontier_kind{ // which open list a_star_search keeps its frontier in
+    FRONTIER_HEAP,  // binary heap ordered on (f, deeper g) --- the default
+    FRONTIER_BUCKET // two-level f/g bucket queue, O(1) push/pop, LIFO among equal (f, g)
+};
 
 
                                                                                     /* =============================================== FUNDAMENTAL DATA STRUCTURES =============================================== */
+template<int N>
+struct board_traits{ // start of board_traits struct definition
+
+    /* per-size constants of an N x N board */
+
+    static constexpr int NN = N * N; // total count of cells on the board
+    static constexpr int TILE_BITS = (NN <= 16) ? 4 : 5; // bits used per cell in the packed board encoding --- tiles up to 15 fit in a nibble, the 24-puzzle needs 5 bits
+    using key_type = conditional_t<NN * TILE_BITS <= 64, uint64_t, unsigned __int128>; // integer holding the packed board --- 36 bits (3x3), 64 bits (4x4), 125 bits (5x5)
+    using grid = array<array<int,N>, N>; // 2D matrix of tiles [row][column]
+
+}; // end of board_traits struct definition
+
+template<int N>
+using board_key = typename board_traits<N>::key_type;
+
+template<int N>
+using board_grid = typename board_traits<N>::grid; // N is never deduced from a grid (std::array sizes are size_t) --- it comes from the other arguments or is spelled out
+
+struct board_key_hash{ // start of board_key_hash struct definition
+
+    /* hash for packed boards --- std::hash has no 128-bit overload, so the 5x5 key folds its two halves together */
+
+    size_t operator()(uint64_t key) const {return hash<uint64_t>()(key);}
+    size_t operator()(unsigned __int128 key) const {return hash<uint64_t>()(static_cast<uint64_t>(key) ^ (static_cast<uint64_t>(key >> 64) * 0x9E3779B97F4A7C15ull));}
+
+}; // end of board_key_hash struct definition
+
+template<int N>
 struct state{ // start of State struct definition
 
-    array<array<int,N>, N> board; // 2D matrix to represent the current state of the board [row][column]
+    board_grid<N> board; // 2D matrix to represent the current state of the board [row][column]
 
     // location of the blank cell on the board as a pair (r,c)
        // the blank's value is denoted as `0`
     int blank_s_row; 
     int blank_s_col;
+
+    // the whole board packed into a single integer, TILE_BITS bits per cell in row-major order (cell 0 in the lowest bits)
+       // this is the state's identity for hashing and comparisons --- kept in sync with `board` on every move
+    board_key<N> packed;
       
 
 }; // end of State struct definition
 
+template<int N>
 struct Node{ // start of Node struct definition
     
-    state s; // current state of the board
+    state<N> s; // current state of the board
     int g;   // path cost --- cost from the initial state to the current state
     int h;   // heuristic cost --- estimated cost from the current state to the goal state
     int f;   // total cost --- f = g + h
+    int h_manhattan; // Manhattan distance part of h (h1/h2) --- kept so children can update h by delta instead of rescanning the board
+    int h_conflicts; // linear conflict count part of h (h2)
     char move; // the last immediate move that led to the current state (L, R, U, D)
-    const Node* parent; // pointer to the parent node of this current node in the search tree
+    uint32_t parent; // id (inside the search's node_arena) of the parent node of this current node in the search tree --- NO_NODE for the root
     
 }; // end of Node struct definition
 
+template<int N>
+struct node_arena{ // start of node_arena struct definition
+
+    /*
+       every Node of a search is carved out of this arena instead of being `new`ed one at a time
+       nodes live in fixed-size slabs that never move, so a node is named by a 32-bit id (slab index in the high bits, offset in the low bits)
+       and a Node& stays valid while more nodes are allocated
+
+       allocation is a bump of `node_count`; the whole search tree is freed in one shot with release() once the solution has been copied out
+    */
+
+    static const int SLAB_SHIFT = 14; // 16384 nodes per slab
+    static const uint32_t SLAB_SIZE = 1u << SLAB_SHIFT;
+
+    vector<unique_ptr<Node<N>[]>> slabs;
+    uint32_t node_count = 0;
+
+    uint32_t allocate(){
+        if(node_count == slabs.size() * SLAB_SIZE){slabs.emplace_back(new Node<N>[SLAB_SIZE]);} // current slabs are full --- grab another one
+        return node_count++;
+    }
+
+    Node<N>& operator[](uint32_t id){return slabs[id >> SLAB_SHIFT][id & (SLAB_SIZE - 1)];}
+    const Node<N>& operator[](uint32_t id) const {return slabs[id >> SLAB_SHIFT][id & (SLAB_SIZE - 1)];}
+
+    void reset(){node_count = 0;} // drops every node of the search at once but keeps the slabs for the next search (batch mode)
+
+    void release(){ // frees every node of the search at once
+        slabs.clear();
+        slabs.shrink_to_fit();
+        node_count = 0;
+    }
+
+}; // end of node_arena struct definition
+
+struct frontier_entry{ // start of frontier_entry struct definition
+
+    /*
+       one entry of the frontier (heap_frontier or bucket_frontier)
+       the f value is copied into the entry when it is pushed, so improving a node never touches entries already inside the heap
+          (changing a key in place would break the heap ordering) --- we push a fresh entry instead and the old one goes stale
+    */
+
+    int f;       // f value of the node at the time the entry was pushed
+    int g;       // g value of the node at the time the entry was pushed --- used to break ties on f
+    uint32_t id; // id of the node inside the node_arena
+
+}; // end of frontier_entry struct definition
+
+enum trace_counter{ // hot-path events counted by search_trace
+    TRACE_DUPLICATE_HITS, // children skipped because their board is already explored at a path at least as cheap
+    TRACE_DECREASE_KEYS,  // frontier nodes given a cheaper path (a fresh entry is pushed, the old one goes stale)
+    TRACE_FRONTIER_PUSHES,
+    TRACE_FRONTIER_POPS,
+    TRACE_COUNTER_COUNT
+};
+
+enum trace_phase{ // hot-path work timed by search_trace
+    TRACE_HEURISTIC, // computing h for new children
+    TRACE_HASHING,   // finding, inserting and closing boards in the state_table
+    TRACE_QUEUE,     // frontier pushes and pops
+    TRACE_PHASE_COUNT
+};
+
+#ifdef SOLVER_TRACE
+
+struct search_trace{ // start of search_trace struct definition
+
+    /*
+       per-solve instrumentation of a_star_search's hot path --- only compiled in with -DSOLVER_TRACE
+       without it search_trace and trace_timer below are empty and every call on them compiles to nothing
+    */
+
+    static const bool enabled = true;
+
+    long long counters[TRACE_COUNTER_COUNT] = {};
+    long long phase_nanoseconds[TRACE_PHASE_COUNT] = {};
+    size_t max_frontier_size = 0; // most frontier entries held at once, stale ones included
+    bool recorded = false;        // the engine that ran fills these --- only a_star_search does; the others leave them at 0
+
+    void mark_recorded(){recorded = true;}
+    void count(trace_counter counter){++counters[counter];}
+    void observe_frontier(size_t frontier_size){max_frontier_size = max(max_frontier_size, frontier_size);}
+
+}; // end of search_trace struct definition
+
+struct trace_timer{ // start of trace_timer struct definition
+
+    /* adds the time until the end of its scope to one phase of a search_trace */
+
+    search_trace& trace;
+    trace_phase phase;
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+
+    trace_timer(search_trace& target, trace_phase timed_phase) : trace(target), phase(timed_phase) {}
+    ~trace_timer(){trace.phase_nanoseconds[phase] += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - started).count();}
+
+}; // end of trace_timer struct definition
+
+#else
+
+struct search_trace{ // compiled-out instrumentation --- see the SOLVER_TRACE version above
+    static const bool enabled = false;
+    void mark_recorded(){}
+    void count(trace_counter){}
+    void observe_frontier(size_t){}
+};
+
+struct trace_timer{
+    trace_timer(search_trace&, trace_phase){}
+};
+
+#endif
+
+struct search_stats{ // start of search_stats struct definition
+
+    /* counters filled in by one search --- `nodes_generated` is line 10 of the output file, the rest are reported on stderr */
+
+    long long nodes_generated = 0; // nodes created (root + each new child)
+    long long nodes_expanded = 0;  // nodes whose children were generated
+    long long stale_entries = 0;   // frontier entries popped and skipped because their node was improved after they were pushed
+    long long nodes_reopened = 0;  // explored nodes moved back to the frontier because a cheaper path to them was found
+    long long frontier_spilled = 0; // frontier records written to disk by the memory-bounded search (--memory)
+    bool memory_exhausted = false;  // the memory-bounded search stopped: its explored set outgrew the budget
+    bool spill_failed = false;      // the memory-bounded search stopped: a spill file could not be created, written or read (already reported on stderr)
+    long long closed_size = -1;     // explored boards left in the engine's own closed table(s) (-1: it keeps none --- IDA*, the oracle, a cache hit)
+    float table_load_factor = 0;    // occupied share of those tables' slots --- frontier entries hold slots too
+    search_trace trace;            // hot-path counters and timings (A* only, empty unless built with -DSOLVER_TRACE)
+
+}; // end of search_stats struct definition
+
 
 
 
                                                                         /* =============================================== HEURISTICS =============================================== */
 
+template<int N>
 struct goal_positions{ // start of goal_positions struct definition
 
     /* 
@@ -57,11 +286,36 @@ struct goal_positions{ // start of goal_positions struct definition
                 goal_positions.col_positions[8] = 1 means that the tile with value 8 is in column 1 of the board
     */
 
-    array<int, NN> row_positions;
-    array<int, NN> col_positions;
+    array<int, N * N> row_positions;
+    array<int, N * N> col_positions;
+    array<uint8_t, N * N> goal_cells; // goal cell (row * N + col) of each tile --- the relabeling the batched heuristic kernels shuffle with
 }; // end of goal_positions struct definition
 
-static int heuristic_h1(const array<array<int,N>, N>& current_board, const goal_positions& gps){ // start of heuristic_h1 function definition
+template<int N>
+static goal_positions<N> record_goal_positions(const board_grid<N>& goal_board){ // start of record_goal_positions function definition
+
+    /* record the goal positions (r,c) for each tile */
+
+    goal_positions<N> gps;
+    for(int each_row = 0; each_row < N; ++each_row){
+
+        for(int each_col = 0; each_col < N; ++each_col){
+            
+            int tile_value = goal_board[each_row][each_col];
+
+            gps.row_positions[tile_value] = each_row;
+            gps.col_positions[tile_value] = each_col;
+            gps.goal_cells[tile_value] = static_cast<uint8_t>(each_row * N + each_col);
+
+        }
+    }
+    
+    return gps;
+
+} // end of record_goal_positions function definition
+
+template<int N>
+static int heuristic_h1(const board_grid<N>& current_board, const goal_positions<N>& gps){ // start of heuristic_h1 function definition
                                                                            // the h1 heuristic is the Manhattan Distance heuristic
 
         int total_manh_dist = 0; // `total` because we are including the Manhattan Distances of ALL tiles in the board
@@ -89,7 +343,8 @@ static int heuristic_h1(const array<array<int,N>, N>& current_board, const goal_
 
 
 
-static int wrong_ordering_counter(const vector<int>& tiles_goal_line){ // start of wrong_ordering_counter function definition
+template<int N>
+static int wrong_ordering_counter(const array<int, N>& tiles_goal_line, int line_length){ // start of wrong_ordering_counter function definition
 
     /*
       we look at each position
@@ -104,15 +359,58 @@ static int wrong_ordering_counter(const vector<int>& tiles_goal_line){ // start
     
     int wrong_ordering_count = 0;
 
-    for(int i = 0; i < tiles_goal_line.size(); ++i){
-        for(int j = i + 1; j < tiles_goal_line.size(); ++j){if(tiles_goal_line[i] > tiles_goal_line[j]){++wrong_ordering_count;}}
+    for(int i = 0; i < line_length; ++i){
+        for(int j = i + 1; j < line_length; ++j){if(tiles_goal_line[i] > tiles_goal_line[j]){++wrong_ordering_count;}}
     }
     return wrong_ordering_count;
 
 } // end of wrong_ordering_counter function definition
 
 
-static int linear_conflicts_counter(const array<array<int,N>, N>& current_board, const goal_positions& gps){ // start of linear_conflicts function definition
+template<int N>
+static int row_conflicts_counter(const board_grid<N>& current_board, const goal_positions<N>& gps, int each_row){ // start of row_conflicts_counter function definition
+
+    /* linear conflicts inside one row --- the collection is a fixed-size array so no allocation happens per line */
+
+    array<int, N> tiles_goal_col; // collection of goal columns of the tiles that sit in their goal row
+    int collected = 0;
+
+    for(int each_col = 0; each_col < N; ++each_col){
+        int tile_value = current_board[each_row][each_col]; // grab the value of the current tile
+        if(tile_value == 0){continue;} // skip the blank cell
+
+        if(gps.row_positions[tile_value] == each_row){tiles_goal_col[collected++] = gps.col_positions[tile_value];} // only consider tiles that are in their correct row
+                                                                                                                        // push this tile's goal column into the collection
+    }
+
+    return wrong_ordering_counter<N>(tiles_goal_col, collected); // pass the collection into the function that counts the number of wrong orderings in the collection
+
+} // end of row_conflicts_counter function definition
+
+
+template<int N>
+static int col_conflicts_counter(const board_grid<N>& current_board, const goal_positions<N>& gps, int each_col){ // start of col_conflicts_counter function definition
+
+    /* linear conflicts inside one column --- mirror image of row_conflicts_counter */
+
+    array<int, N> tiles_goal_row; // collection of goal rows of the tiles that sit in their goal column
+    int collected = 0;
+
+    for(int each_row = 0; each_row < N; ++each_row){
+        int tile_value = current_board[each_row][each_col]; // grab the value of the current tile
+        if(tile_value == 0){continue;} // skip the blank cell
+
+        if(gps.col_positions[tile_value] == each_col){tiles_goal_row[collected++] = gps.row_positions[tile_value];} // only consider tiles that are in their correct column
+                                                                                                                        // push this tile's goal row into the collection
+    }
+
+    return wrong_ordering_counter<N>(tiles_goal_row, collected); // pass the collection into the function that counts the number of wrong orderings in the collection
+
+} // end of col_conflicts_counter function definition
+
+
+template<int N>
+static int linear_conflicts_counter(const board_grid<N>& current_board, const goal_positions<N>& gps){ // start of linear_conflicts function definition
     
     /* 
 
@@ -128,457 +426,4397 @@ static int linear_conflicts_counter(const array<array<int,N>, N>& current_board,
 
     int total_linear_conflicts = 0;
 
-    // row pass
-    for(int each_row = 0; each_row < N; ++each_row){
-        
-        vector<int> tiles_goal_col; // collection of goal p
+    for(int each_row = 0; each_row < N; ++each_row){total_linear_conflicts += row_conflicts_counter(current_board, gps, each_row);} // row pass
+    for(int each_col = 0; each_col < N; ++each_col){total_linear_conflicts += col_conflicts_counter(current_board, gps, each_col);} // column pass
+
+    return total_linear_conflicts;
+
+} // end of linear_conflicts function definition
 
+
+static const uint8_t* pdb_table = nullptr; // exact distance table used by h3 --- memory-mapped read-only at startup by load_pattern_database (nullptr until then)
+
+template<int N>
+static int pdb_index(const board_grid<N>& current_board, const goal_positions<N>& gps){ // start of pdb_index function definition
+
+    /*
+       maps a board to its slot in the pattern database
+
+       the database holds one table per goal blank cell; each table was built against the "canonical" goal for that blank cell
+          (tiles 1..8 in reading order around the blank), so we first relabel every tile by the reading-order slot of its goal cell
+          --- after relabeling, the user's goal IS the canonical goal and the distances carry over unchanged
+
+       inside a table: slot = blank cell * 8!/2 + (Lehmer rank of the 8 relabeled tiles in reading order) / 2
+          only half of the 8! tile orders are reachable for a given blank cell (parity), and ranks 2k and 2k+1 differ by swapping
+          the last two tiles (opposite parity), so dividing the rank by 2 packs the reachable half with no holes
+    */
+
+    static_assert(N * N == PDB_CELLS, "the pattern database only covers 3x3 boards");
+    static const int factorial[8] = {5040, 720, 120, 24, 6, 2, 1, 1}; // (7-i)! for the i-th tile of the sequence
+
+    int goal_blank_cell = gps.row_positions[0] * N + gps.col_positions[0];
+    int blank_cell = 0;
+    int tiles_seen = 0;
+    unsigned labels_seen = 0; // bitmask of relabeled tiles already placed
+    int rank = 0;
+
+    for(int each_row = 0; each_row < N; ++each_row){
         for(int each_col = 0; each_col < N; ++each_col){
-            int tile_value = current_board[each_row][each_col]; // grab the value of the current tile
-            if(tile_value == 0){continue;} // skip the blank cell
 
-            if(gps.row_positions[tile_value] == each_row){tiles_goal_col.push_back(gps.col_positions[tile_value]);} // only consider tiles that are in their correct row
-                                                                                                                       // push this tile's goal column into the collection
+            int tile_value = current_board[each_row][each_col];
+            if(tile_value == 0){blank_cell = each_row * N + each_col; continue;} // the blank is not part of the tile order
 
-        }
-        
-        total_linear_conflicts += wrong_ordering_counter(tiles_goal_col); // pass the collection into the function that counts the number of wrong orderings in the collection
+            int goal_cell = gps.row_positions[tile_value] * N + gps.col_positions[tile_value];
+            int label = (goal_cell < goal_blank_cell) ? goal_cell : goal_cell - 1; // reading-order slot of the goal cell, skipping the blank
 
+            int smaller_labels_seen = __builtin_popcount(labels_seen & ((1u << label) - 1));
+            rank += (label - smaller_labels_seen) * factorial[tiles_seen]; // Lehmer digit: how many smaller labels are still to come
+            labels_seen |= 1u << label;
+            ++tiles_seen;
+        }
     }
-    // end of row pass
 
+    return goal_blank_cell * PDB_ENTRIES_PER_GOAL + blank_cell * PDB_ENTRIES_PER_BLANK + (rank >> 1);
 
-    // column pass
-    for(int each_col = 0; each_col < N; ++each_col){
-        
-        vector<int> tiles_goal_row;
+} // end of pdb_index function definition
 
-        for(int each_row = 0; each_row < N; ++each_row){
-            int tile_value = current_board[each_row][each_col]; // grab the value of the current tile
-            if(tile_value == 0){continue;} // skip the blank cell
 
-            if(gps.col_positions[tile_value] == each_col){tiles_goal_row.push_back(gps.row_positions[tile_value]);} // only consider tiles that are in their correct column
-                                                                                                                       // push this tile's goal row into the collection
-        }
+template<int N>
+static int heuristic_h3(const board_grid<N>& current_board, const goal_positions<N>& gps){ // start of heuristic_h3 function definition
+                                                                                                // the h3 heuristic is the exact distance to the goal, read from the pattern database
+    if constexpr(N * N == PDB_CELLS){return pdb_table[pdb_index(current_board, gps)];}
+    else{return 0;} // never reached --- h3 is refused for other board sizes before any search runs
 
-        total_linear_conflicts += wrong_ordering_counter(tiles_goal_row); // pass the collection into the function that counts the number of wrong orderings in the collection
+} // end of heuristic_h3 function definition
 
-    }
-    // end of column pass
 
-    return total_linear_conflicts;
+template<int N>
+static int evaluate_heuristic(const board_grid<N>& current_board, const goal_positions<N>& gps, int heuristic_choice, int& manhattan, int& conflicts){ // start of evaluate_heuristic function definition
+    
+    /* 
+       heuristic depends on what the user chose
+       also hands back the Manhattan distance and linear conflict count behind h1/h2 so a child can update them by delta (see evaluate_heuristic_after_move)
+    */
 
-} // end of linear_conflicts function definition
+    if(heuristic_choice == 3){manhattan = 0; conflicts = 0; return heuristic_h3(current_board, gps);} // table lookup --- nothing to carry over
 
+    // the h1 heuristic is the Manhattan Distance, the h2 heuristic is the sum of the h1 heuristic and 2 times the number of linear conflicts
+    manhattan = heuristic_h1(current_board, gps);
+    conflicts = (heuristic_choice == 2) ? linear_conflicts_counter(current_board, gps) : 0;
+    return manhattan + 2 * conflicts;
 
-static int heuristic_h2(const array<array<int,N>, N>& current_board, const goal_positions& gps){ // start of heuristic_h2 function definition
-                                                                                                               // the h2 heuristic is the sum of the h1 heuristic and 2 times the number of linear conflicts
-    int h1 = heuristic_h1(current_board, gps);
-    int linear_conflict_count = linear_conflicts_counter(current_board, gps);
+} // end of evaluate_heuristic function definition
 
-    return h1 + 2 * linear_conflict_count;
-} // end of heuristic_h2 function definition
 
+template<int N>
+static int slide_manhattan_delta(int tile_value, int from_row, int from_col, int to_row, int to_col, const goal_positions<N>& gps){ // start of slide_manhattan_delta function definition
+    
+    /* change in the Manhattan distance when `tile_value` slides from (from_row, from_col) to (to_row, to_col) --- always +1 or -1 */
 
+    int goal_row = gps.row_positions[tile_value], goal_col = gps.col_positions[tile_value];
+    return (abs(to_row - goal_row) + abs(to_col - goal_col)) - (abs(from_row - goal_row) + abs(from_col - goal_col));
 
-                                                     /* =============================================== A* SEARCH ALGORITHM =============================================== */
+} // end of slide_manhattan_delta function definition
 
 
-static string board_to_string(const array<array<int,N>, N>& board){ // start of board_to_string function definition
+template<int N>
+static int slide_line_conflicts(const board_grid<N>& current_board, const goal_positions<N>& gps, int from_row, int from_col, int to_row, int to_col){ // start of slide_line_conflicts function definition
     
-    /* converts the board state to a string representation of the board */
+    /*
+       linear conflicts in the only two lines a slide between (from_row, from_col) and (to_row, to_col) can change
+          a horizontal slide keeps the tile in its row without passing any tile, so the rows are unchanged
+          and only the two columns it leaves and enters matter (vertical slide: the two rows)
+       counting these on the board before and after the slide gives the change in the total
+    */
 
-    string board_str;
+    if(from_row == to_row){return col_conflicts_counter(current_board, gps, from_col) + col_conflicts_counter(current_board, gps, to_col);} // horizontal slide
+    return row_conflicts_counter(current_board, gps, from_row) + row_conflicts_counter(current_board, gps, to_row); // vertical slide
 
-    for(int each_row = 0; each_row < N; ++each_row){
-        
-        for(int each_col = 0; each_col < N; ++each_col){
+} // end of slide_line_conflicts function definition
 
-            board_str += to_string(board[each_row][each_col]);
-        }
 
+template<int N>
+static int evaluate_heuristic_after_move(const state<N>& parent_state, const state<N>& child_state, const goal_positions<N>& gps, int heuristic_choice, int parent_manhattan, int parent_conflicts, int& manhattan, int& conflicts){ // start of evaluate_heuristic_after_move function definition
+    
+    /*
+       same result as evaluate_heuristic on the child's board, but derived from the parent's parts
+
+       a move slides exactly one tile: from the child's blank cell into the parent's blank cell
+          Manhattan: only that tile's distance changes (by +1 or -1)
+          linear conflicts: only the two lines the tile leaves and enters are recounted (see slide_line_conflicts)
+    */
 
+    if(heuristic_choice == 3){manhattan = 0; conflicts = 0; return heuristic_h3(child_state.board, gps);}
+
+    int from_row = child_state.blank_s_row, from_col = child_state.blank_s_col;   // where the tile was
+    int to_row = parent_state.blank_s_row, to_col = parent_state.blank_s_col;     // where the tile is now
+    int tile_value = child_state.board[to_row][to_col];
+
+    manhattan = parent_manhattan + slide_manhattan_delta(tile_value, from_row, from_col, to_row, to_col, gps);
+
+    conflicts = parent_conflicts;
+    if(heuristic_choice == 2){
+        conflicts += slide_line_conflicts(child_state.board, gps, from_row, from_col, to_row, to_col)
+                   - slide_line_conflicts(parent_state.board, gps, from_row, from_col, to_row, to_col);
     }
 
-    return board_str;
+    return manhattan + 2 * conflicts;
+
+} // end of evaluate_heuristic_after_move function definition
 
-} // end of board_to_string function definition
 
 
+                                                     /* =============================================== A* SEARCH ALGORITHM =============================================== */
+
 
-static bool is_goal_state(const state& current_state, const state& gs){ // start of is_goal_state function definition
+template<int N>
+static board_key<N> pack_board(const board_grid<N>& board){ // start of pack_board function definition
     
-    /* checks if the current board state is the goal state */
+    /* packs the board into a single integer (TILE_BITS bits per cell) so states can be hashed and compared without building strings */
+
+    board_key<N> packed = 0;
 
     for(int each_row = 0; each_row < N; ++each_row){
         
         for(int each_col = 0; each_col < N; ++each_col){
-            
-            if(current_state.board[each_row][each_col] != gs.board[each_row][each_col]){return false;}
 
+            int cell = each_row * N + each_col; // row-major index of the cell
+            packed |= static_cast<board_key<N>>(board[each_row][each_col]) << (cell * board_traits<N>::TILE_BITS);
         }
 
 
     }
-    // if we get here, then we found a match for every tile in the current board state with the goal board state
-
-    return true; 
-
-} // end of is_goal_state function definition
 
+    return packed;
 
+} // end of pack_board function definition
 
 
-static vector<pair<char, state>> generate_children(const state& current_state){ // start of generate_children function definition
-     
-    /* the purpose of this function is to generate all successor (aka child) states from the current state */
 
-    vector<pair<char, state>> children; // a collection to hold all of the actions and the resulting states
+template<int N>
+static bool is_goal_state(const state<N>& current_state, const state<N>& gs){ // start of is_goal_state function definition
+    
+    /* checks if the current board state is the goal state */
 
-    // all the possible actions that can be taken from the current state
-       // {dr, dc, action char} --- dr is the change in row, dc is the change in column, action char is the action that was taken
-    vector<tuple<int, int, char>> actions = {
-        {0, -1, 'L'},
-        {0, 1, 'R'},
-        {-1, 0, 'U'},
-        {1, 0, 'D'}
-    };
+    return current_state.packed == gs.packed; // the packed encodings match exactly when every tile matches
 
+} // end of is_goal_state function definition
 
-    for(const auto& [dr, dc, action] : actions){ // start of processing each action
 
-        int blank_row = current_state.blank_s_row;
-        int blank_col = current_state.blank_s_col;
 
-        int new_blank_row = blank_row + dr;
-        int new_blank_col = blank_col + dc;
+template<int N>
+static bool is_solvable(const state<N>& initial_state, const state<N>& goal_state){ // start of is_solvable function definition
+    
+    /*
+       O(NN) parity pre-check --- every move swaps the blank with a neighbour, so it flips both
+          (a) the parity of the permutation taking the start board to the goal board (the blank counted as a tile), and
+          (b) the parity of the blank's Manhattan distance from its goal cell
+       both are 0 at the goal, so the goal is reachable exactly when (a) and (b) agree
+          (with the blank left out and an odd board width, this is the usual "same inversion parity" test)
+       exactly half of all start/goal pairs fail it; without this check A* would sweep all 181,440 reachable states before giving up
+    */
 
-        if(new_blank_row < 0 || new_blank_row >= N || new_blank_col < 0 || new_blank_col >= N){continue;} // skip if the new position is out of bounds
-        
+    goal_positions<N> gps = record_goal_positions<N>(goal_state.board);
 
-        // reaching here means the new position of the blank cell is within the bounds of the board
+    // where the tile in each cell has to end up
+    array<int, N * N> destination;
+    for(int each_cell = 0; each_cell < N * N; ++each_cell){
+        int tile_value = initial_state.board[each_cell / N][each_cell % N];
+        destination[each_cell] = gps.row_positions[tile_value] * N + gps.col_positions[tile_value];
+    }
 
+    // parity of a permutation = parity of (cells - cycles)
+    array<bool, N * N> visited{};
+    int cycle_count = 0;
+    for(int each_cell = 0; each_cell < N * N; ++each_cell){
+        if(visited[each_cell]){continue;}
+        ++cycle_count;
+        for(int cell = each_cell; !visited[cell]; cell = destination[cell]){visited[cell] = true;}
+    }
+    int permutation_parity = (N * N - cycle_count) % 2;
 
-        // create a new state that is the result of the action
-        state new_state = current_state;
-        swap(new_state.board[blank_row][blank_col], new_state.board[new_blank_row][new_blank_col]); // swap the blank cell with the tile in the new position
-                                                                                                       // simulate the move that was made
-        // update the blank cell's position in the new state
-        new_state.blank_s_row = new_blank_row;
-        new_state.blank_s_col = new_blank_col;
+    int blank_distance = abs(initial_state.blank_s_row - goal_state.blank_s_row) + abs(initial_state.blank_s_col - goal_state.blank_s_col);
 
+    return permutation_parity == blank_distance % 2;
 
-        children.push_back({action, new_state}); // add the new state to the children vector
+} // end of is_solvable function definition
 
-    } // end of processing each action
 
-    return children;
 
 
-} // end of generate_children function definition
+struct move_option{ // one legal slide of the blank: where it goes and the action char
+    int target_cell; // row-major index of the cell the blank moves into
+    char action;     // L, R, U or D
+};
 
+struct move_table_row{ // every legal slide of the blank from one cell, in L, R, U, D order
+    move_option options[4];
+    int count;
+};
 
+template<int N>
+static constexpr array<move_table_row, N * N> build_move_table(){ // start of build_move_table function definition
+    
+    /* precomputes, for each blank cell, the moves that stay on the board --- so successor generation needs no bounds checks */
 
+    // all the possible actions
+       // {dr, dc, action char} --- dr is the change in row, dc is the change in column, action char is the action that was taken
+    const int deltas[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+    const char actions[4] = {'L', 'R', 'U', 'D'};
 
-static const Node* a_star_search(const state& initial_state, const state& goal_state, int heuristic_choice, long long& nodes_generated){ // start of a_star_search function definition
-    
+    array<move_table_row, N * N> table{};
+    for(int each_cell = 0; each_cell < N * N; ++each_cell){
 
-    // record the goal positions for each tile
-    goal_positions gps;
-    for(int each_row = 0; each_row < N; ++each_row){
+        int blank_row = each_cell / N;
+        int blank_col = each_cell % N;
 
-        for(int each_col = 0; each_col < N; ++each_col){
-            
-            int tile_value = goal_state.board[each_row][each_col];
+        for(int each_action = 0; each_action < 4; ++each_action){
+            int new_blank_row = blank_row + deltas[each_action][0];
+            int new_blank_col = blank_col + deltas[each_action][1];
 
-            gps.row_positions[tile_value] = each_row;
-            gps.col_positions[tile_value] = each_col;
+            if(new_blank_row < 0 || new_blank_row >= N || new_blank_col < 0 || new_blank_col >= N){continue;} // skip if the new position is out of bounds
 
+            move_table_row& row = table[each_cell];
+            row.options[row.count].target_cell = new_blank_row * N + new_blank_col;
+            row.options[row.count].action = actions[each_action];
+            ++row.count;
         }
     }
-    // end of recording the goal positions for each tile
 
+    return table;
 
+} // end of build_move_table function definition
 
-    auto node_comparator = [](const Node* n1, const Node* n2){return n1->f > n2->f;}; // `greater than` for min heap
-    priority_queue<Node*, vector<Node*>, decltype(node_comparator)> frontier(node_comparator); // INITIALIZE FRONTIER --- FRONTIER is a priority queue of nodes sorted by the f value of the nodes
+template<int N>
+static constexpr array<move_table_row, N * N> MOVE_TABLE = build_move_table<N>(); // one table per board size, built at compile time
 
 
-    // WE NEED THESE SINCE WE'RE DOING A GRAPH SEARCH SO THESE HELP US TRACK REPEATS
-    unordered_set<string> explored; // set to keep track of explored state using a string representation of the board
-    unordered_map<string, Node*> frontier_map; // hash map to keep track of the board state and the node that represents it in the frontier
+static char inverse_move(char move){ // start of inverse_move function definition
+    
+    /* the action that undoes `move` */
+
+    switch(move){
+        case 'L': return 'R';
+        case 'R': return 'L';
+        case 'U': return 'D';
+        case 'D': return 'U';
+        default:  return '\0';
+    }
 
+} // end of inverse_move function definition
 
 
+template<int N>
+static void make_move(state<N>& current_state, int target_cell){ // start of make_move function definition
     
-    // creating the root node
-    Node* root_node = new Node();
-    root_node->s = initial_state;
-    root_node-> g = 0;
-    root_node->h = (heuristic_choice == 1) ? heuristic_h1(initial_state.board, gps) : heuristic_h2(initial_state.board, gps); // heuristic depends on what the user chose
-    root_node->f = root_node->g + root_node->h;
-    root_node->move = '\0'; 
-    root_node->parent = nullptr;
-    
-    // adding the root node (aka initial node) to the frontier --- get things started
-    frontier.push(root_node);
-    frontier_map[board_to_string(initial_state.board)] = root_node;
-    ++nodes_generated;
-
+    /*
+       slides the tile in `target_cell` (a neighbour of the blank) into the blank cell, in place
+       sliding it back (make_move with the old blank cell) undoes the move exactly --- IDA* relies on this
+    */
 
+    int blank_row = current_state.blank_s_row;
+    int blank_col = current_state.blank_s_col;
+    int blank_cell = blank_row * N + blank_col;
+    int new_blank_row = target_cell / N;
+    int new_blank_col = target_cell % N;
 
-    // CORE A* SEARCH LOOP
-    while(!frontier.empty()){ // start of the core A* search loop
+    int moved_tile = current_state.board[new_blank_row][new_blank_col];
+    current_state.board[blank_row][blank_col] = moved_tile; // slide the tile into the blank cell
+    current_state.board[new_blank_row][new_blank_col] = 0;   // simulate the move that was made
 
-        // grab the node with the lowest f value from the frontier
-        Node* current_node = frontier.top(); frontier.pop();
+    // patch the packed encoding: the moved tile lands in the old blank cell and the new blank cell becomes 0
+    current_state.packed |= static_cast<board_key<N>>(moved_tile) << (blank_cell * board_traits<N>::TILE_BITS);
+    current_state.packed &= ~(static_cast<board_key<N>>((1 << board_traits<N>::TILE_BITS) - 1) << (target_cell * board_traits<N>::TILE_BITS));
 
-        string current_state_str = board_to_string(current_node->s.board);
-        frontier_map.erase(current_state_str); // remove the current node from the frontier map
+    // update the blank cell's position
+    current_state.blank_s_row = new_blank_row;
+    current_state.blank_s_col = new_blank_col;
 
-        
-        if(is_goal_state(current_node->s, goal_state)){return current_node;} // GOAL TEST --- did we find the goal state?
+} // end of make_move function definition
 
-        
-        explored.insert(current_state_str); // add this current node to the explored set --- marking it as explored
 
-        vector<pair<char, state>> children = generate_children(current_node->s);// GENERATE CHILDREN NODES (AKA NEXT ACTION NODES)
+template<int N>
+static board_key<N> slide_key(board_key<N> packed, int blank_cell, int target_cell){ // start of slide_key function definition
+    
+    /* make_move on the packed encoding alone: the tile in `target_cell` slides into `blank_cell` */
 
-        for(const auto& [move, next_state] : children){ // start of processing each child node
+    constexpr int BITS = board_traits<N>::TILE_BITS;
+    const board_key<N> tile_mask = (board_key<N>(1) << BITS) - 1;
 
-            string child_state_str = board_to_string(next_state.board);
+    board_key<N> tile_value = (packed >> (target_cell * BITS)) & tile_mask;
+    return (packed | (tile_value << (blank_cell * BITS))) & ~(tile_mask << (target_cell * BITS));
 
-            if(explored.count(child_state_str) > 0){continue;} // skip this child node's state if it has already been explored
-            
-            // computing child's costs (g, h and ultimately f)
-            int child_g = current_node->g + 1; // path cost --- cost from the initial state to the current state
-            int child_h = (heuristic_choice == 1) ? heuristic_h1(next_state.board, gps) : heuristic_h2(next_state.board, gps);
-            int child_f = child_g + child_h;
+} // end of slide_key function definition
 
-            auto frontier_map_iter = frontier_map.find(child_state_str);
-            if(frontier_map_iter!= frontier_map.end()){
 
-                // reaching here means that this child node's state is already in the frontier
-                // we need to check if the child node's f value is less than the f value of the node in the frontier with the same state
-                
-                Node* existing_node = frontier_map_iter->second;
-                if(child_f < existing_node->f){
-                    // update the existing node in the frontier with better costs
-                    existing_node->g = child_g;
-                    existing_node->f = child_f;
-                    existing_node->move = move;
-                    existing_node->parent = current_node;
-                }
-            }
-            else{
-               
-                // reaching here means that this child node's state is NOT in the frontier yet
-                
-                // creating the child node
-                Node* child_node = new Node();
-                child_node->s = next_state;
-                child_node->g = child_g;
-                child_node->h = child_h;
-                child_node->f = child_f;
-                child_node->move = move;
-                child_node->parent = current_node;
+template<int N>
+struct successor_list{ // start of successor_list struct definition
+    
+    /* fixed-capacity collection of (action, child state) pairs --- lives on the stack so successor generation never touches the heap */
 
+    pair<char, state<N>> children[4];
+    int count = 0;
 
-                // adding the child node to the frontier
-                frontier.push(child_node);
-                frontier_map[child_state_str] = child_node;
-                ++nodes_generated;
+    const pair<char, state<N>>* begin() const {return children;}
+    const pair<char, state<N>>* end() const {return children + count;}
 
-            }
+}; // end of successor_list struct definition
 
-        } // end of processing each child node
 
-    } // end of the core A* search loop
-    
-    return nullptr; // no solution found
+template<int N>
+static void generate_children(const state<N>& current_state, char parent_move, successor_list<N>& children){ // start of generate_children function definition
+     
+    /* 
+       the purpose of this function is to generate all successor (aka child) states from the current state into `children`
+       the child that would undo `parent_move` (the action that led to current_state) is pruned up front --- it is the parent, which is always cheaper
+          pass '\0' as `parent_move` to get every child
+    */
 
-} // end of a_star_search function definition
+    children.count = 0;
 
+    int blank_cell = current_state.blank_s_row * N + current_state.blank_s_col;
+    char undo_move = inverse_move(parent_move);
 
+    const move_table_row& legal_moves = MOVE_TABLE<N>[blank_cell];
+    for(int each_option = 0; each_option < legal_moves.count; ++each_option){ // start of processing each action
 
+        const move_option& option = legal_moves.options[each_option];
+        if(option.action == undo_move){continue;} // going straight back to the parent
 
+        // create a new state that is the result of the action
+        pair<char, state<N>>& child = children.children[children.count++];
+        child.first = option.action;
+        child.second = current_state;
+        make_move(child.second, option.target_cell);
 
+    } // end of processing each action
 
+} // end of generate_children function definition
 
 
+template<int N>
+static void replay_fvalues(const state<N>& initial_state, const vector<char>& actions, const goal_positions<N>& gps, int heuristic_choice, vector<int>& fvalues){ // start of replay_fvalues function definition
+    
+    /* walks `actions` from `initial_state` and appends the f value (g + h toward the goal in `gps`) of every board on the path, root included */
+
+    state<N> current_state = initial_state;
+    int manhattan, conflicts;
+    fvalues.push_back(evaluate_heuristic(current_state.board, gps, heuristic_choice, manhattan, conflicts));
+    for(size_t each_action = 0; each_action < actions.size(); ++each_action){
+        const move_table_row& legal_moves = MOVE_TABLE<N>[current_state.blank_s_row * N + current_state.blank_s_col];
+        for(int each_option = 0; each_option < legal_moves.count; ++each_option){
+            if(legal_moves.options[each_option].action == actions[each_action]){make_move(current_state, legal_moves.options[each_option].target_cell); break;}
+        }
+        fvalues.push_back(static_cast<int>(each_action) + 1 + evaluate_heuristic(current_state.board, gps, heuristic_choice, manhattan, conflicts));
+    }
 
+} // end of replay_fvalues function definition
 
 
 
 
+struct heap_frontier{ // start of heap_frontier struct definition
 
+    /* binary heap frontier --- lowest f first, ties on f go to the deeper node, which is closer to the goal */
 
-/* =============================================== MAIN =============================================== */
+    struct entry_comparator{
+        bool operator()(const frontier_entry& e1, const frontier_entry& e2) const {return e1.f > e2.f || (e1.f == e2.f && e1.g < e2.g);} // `greater than` for min heap
+    };
 
+    vector<frontier_entry> heap; // heap-ordered with push_heap/pop_heap (rather than a priority_queue) so clear() keeps the capacity between searches
 
-static void print_board(const array<array<int,N>, N>& board){ // start of print_board function definition
-    
-    /* print the board in the required format */
+    void push(const frontier_entry& entry){heap.push_back(entry); push_heap(heap.begin(), heap.end(), entry_comparator());}
+    frontier_entry pop(){pop_heap(heap.begin(), heap.end(), entry_comparator()); frontier_entry top_entry = heap.back(); heap.pop_back(); return top_entry;}
+    bool empty() const {return heap.empty();}
+    size_t size() const {return heap.size();}
+    int min_f() const {return heap.empty() ? INT_MAX : heap.front().f;} // f of the next pop (INT_MAX when empty)
+    void clear(){heap.clear();}
 
-    for(int each_row = 0; each_row < N; ++each_row){
-        for(int each_col = 0; each_col < N; ++each_col){
-            cout << board[each_row][each_col];
-        }
-        cout << '\n';
-    }
-} // end of print_board function definition
+}; // end of heap_frontier struct definition
 
-static void reconstruct_solution(const Node* final_node, vector<char>& actions, vector<int>& fvalues){ // start of reconstruct_solution function definition
-     
-    /* reconstruct the solution path by manipulating the `actions` and `fvalues` collections */
+struct bucket_frontier{ // start of bucket_frontier struct definition
 
-    const Node* current_node = final_node;
+    /*
+       f values here are small integers (about 31 + the largest h), so instead of comparing entries we drop each one into a bucket
+          buckets[f][g] is a stack of node ids that share the same f and g
 
-    while(current_node->parent != nullptr){
-        actions.push_back(current_node->move); // reminder: `move` is the action that led to the current node from its parent node
-        fvalues.push_back(current_node->f);   // put the f values of nodes on the solution path into the collection
-        current_node = current_node->parent; // simulate going up the tree to the parent node
-    }
-    // when current_node is the root node, we don't want to put the action into the collection but we do want to put the f value into the collection
-    fvalues.push_back(current_node->f);   // put the f value of the root node into the collection
+       pop takes the lowest f layer, inside it the highest g (deeper nodes are closer to the goal), and inside that the most recently pushed id (LIFO)
+       the last f layer is where A* burns most of its ties, and this ordering dives straight to the goal through it
 
+       push and pop are O(1) amortized: `lowest_f` and each layer's `top_g` only move past buckets that are empty
+    */
 
+    vector<vector<vector<uint32_t>>> buckets; // [f][g] --> LIFO stack of node ids
+    vector<int> top_g;                        // [f] highest g that may still hold entries in that layer (-1 when the layer never had any)
+    vector<size_t> layer_size;                // [f] number of entries in that layer
+    int lowest_f = INT_MAX;                   // no layer below this holds entries
+    size_t total_size = 0;
 
-    // reaching here, our solution path collections are in reverse order
+    void push(const frontier_entry& entry){
+        
+        if(entry.f >= static_cast<int>(buckets.size())){ // grow to hold this f layer
+            buckets.resize(entry.f + 1);
+            top_g.resize(entry.f + 1, -1);
+            layer_size.resize(entry.f + 1, 0);
+        }
 
-    reverse(actions.begin(), actions.end()); // correct order is root --> n1 --> n2 --> ... --> final_node
-    reverse(fvalues.begin(), fvalues.end());
+        vector<vector<uint32_t>>& layer = buckets[entry.f];
+        if(entry.g >= static_cast<int>(layer.size())){layer.resize(entry.g + 1);} // grow to hold this g bucket
 
-} // end of reconstruct_solution function definition
+        layer[entry.g].push_back(entry.id);
+        top_g[entry.f] = max(top_g[entry.f], entry.g);
+        ++layer_size[entry.f];
+        ++total_size;
+        lowest_f = min(lowest_f, entry.f); // a re-opened node can land below the current layer
+    }
 
+    frontier_entry pop(){
 
+        while(layer_size[lowest_f] == 0){++lowest_f;} // skip emptied layers
 
-static bool read_in(const string& filename, state& initial_state, state& goal_state){ // start of read_in function definition
-    
-    ifstream input_file(filename); // open the input file
+        vector<vector<uint32_t>>& layer = buckets[lowest_f];
+        int& g = top_g[lowest_f];
+        while(layer[g].empty()){--g;} // skip emptied g buckets
 
-    if(!input_file){cerr << "Failed to open the input file. Please retry." << endl; return false;}
+        frontier_entry top_entry = {lowest_f, g, layer[g].back()};
+        layer[g].pop_back();
+        --layer_size[lowest_f];
+        --total_size;
+        return top_entry;
+    }
 
-    
-    // read in the initial state
-    for(int each_row = 0; each_row < N; ++each_row){
+    bool empty() const {return total_size == 0;}
+    size_t size() const {return total_size;}
 
-        for(int each_col = 0; each_col < N; ++each_col){
-            
-            input_file >> initial_state.board[each_row][each_col]; // READ INTO THE INITIAL STATE BOARD
-            
-            // record the location of the blank (represented as `0`)
-            if(initial_state.board[each_row][each_col] == 0){
-                initial_state.blank_s_row = each_row;
-                initial_state.blank_s_col = each_col;
-            }
+    int min_f(){ // f of the next pop (INT_MAX when empty)
+        if(total_size == 0){return INT_MAX;}
+        while(layer_size[lowest_f] == 0){++lowest_f;}
+        return lowest_f;
+    }
 
+    void clear(){ // empties every bucket but keeps their capacity for the next search
+        for(vector<vector<uint32_t>>& layer : buckets){
+            for(vector<uint32_t>& bucket : layer){bucket.clear();}
         }
+        fill(top_g.begin(), top_g.end(), -1);
+        fill(layer_size.begin(), layer_size.end(), 0);
+        lowest_f = INT_MAX;
+        total_size = 0;
     }
 
+}; // end of bucket_frontier struct definition
 
-    // the blank line in the input file is ignored by the >> operator
 
+template<int N>
+struct state_table{ // start of state_table struct definition
 
-    // read in the goal state
+    /*
+       every board a search has reached, mapped to the id of the node that holds it --- plus whether that node is explored (closed) or still in the frontier
+       one flat open-addressing table with linear probing: a lookup hashes the packed board once and walks neighbouring slots of one array,
+          instead of chasing a list node per lookup in two separate unordered_maps
+
+       moving a node between the frontier and the explored set only flips CLOSED_BIT in its slot, so entries are never erased (no tombstones)
+       each slot carries the generation it was written in; clear() just starts a new generation, so a batch reuses the table without wiping it
+       3x3 boards size the table up front to hold the whole state space (9!/2 boards) under half load; larger boards start smaller and double at half load
+    */
+
+    static const uint32_t CLOSED_BIT = 1u << 31; // set in a slot's value while its node is explored (node ids stay far below 2^31)
+
+    struct slot{
+        board_key<N> key;    // packed board --- only meaningful when `generation` is the table's current one
+        uint32_t value;      // node id, plus CLOSED_BIT
+        uint32_t generation;
+    };
+
+    vector<slot> slots;
+    int capacity_bits = 0;
+    uint32_t generation = 0;
+    size_t used = 0;         // boards in the current generation
+    size_t closed_count = 0; // of those, the explored ones
+
+    size_t home_slot(board_key<N> key) const { // Fibonacci hashing: the top bits of key * 2^64/phi
+        uint64_t folded = static_cast<uint64_t>(key) ^ static_cast<uint64_t>(key >> (sizeof(key) * 8 / 2) >> (sizeof(key) * 8 / 2)); // high half of a 128-bit key (0 for 64-bit keys)
+        return static_cast<size_t>((folded * 0x9E3779B97F4A7C15ull) >> (64 - capacity_bits));
+    }
+
+    void clear(){
+        if(++generation == 0){ // the counter wrapped --- old stamps could look current again, so wipe them once
+            for(slot& each_slot : slots){each_slot.generation = 0;}
+            generation = 1;
+        }
+        if(slots.empty()){resize(N * N == PDB_CELLS ? 19 : 16);} // 2^19 slots hold all 181440 8-puzzle boards at a 0.35 load
+        used = 0;
+        closed_count = 0;
+    }
+
+    uint32_t* find(board_key<N> key){ // the slot value for `key`, or nullptr when the board has not been reached
+        size_t mask = slots.size() - 1;
+        for(size_t index = home_slot(key); ; index = (index + 1) & mask){
+            slot& each_slot = slots[index];
+            if(each_slot.generation != generation){return nullptr;} // an empty slot ends the probe
+            if(each_slot.key == key){return &each_slot.value;}
+        }
+    }
+
+    void insert(board_key<N> key, uint32_t node_id){ // `key` must not be in the table yet
+        if(2 * (used + 1) > slots.size()){resize(capacity_bits + 1);}
+        place(key, node_id);
+        ++used;
+    }
+
+    void close(uint32_t& value){value |= CLOSED_BIT; ++closed_count;}          // node moved to the explored set
+    void reopen(uint32_t& value, uint32_t node_id){value = node_id; --closed_count;} // explored node moved back to the frontier
+    static bool is_closed(uint32_t value){return (value & CLOSED_BIT) != 0;}
+    static uint32_t node_of(uint32_t value){return value & ~CLOSED_BIT;}
+
+    size_t size() const {return used;}
+    float load_factor() const {return slots.empty() ? 0.0f : static_cast<float>(used) / slots.size();}
+
+    void place(board_key<N> key, uint32_t value){
+        size_t mask = slots.size() - 1;
+        size_t index = home_slot(key);
+        while(slots[index].generation == generation){index = (index + 1) & mask;}
+        slots[index] = {key, value, generation};
+    }
+
+    void resize(int new_capacity_bits){ // rehashes the current generation into 2^new_capacity_bits empty slots (generation 0 is never current)
+        vector<slot> old_slots(size_t(1) << new_capacity_bits);
+        old_slots.swap(slots);
+        capacity_bits = new_capacity_bits;
+        for(const slot& each_slot : old_slots){
+            if(each_slot.generation == generation){place(each_slot.key, each_slot.value);}
+        }
+    }
+
+}; // end of state_table struct definition
+
+
+template<int N>
+struct search_context{ // start of search_context struct definition
+
+    /*
+       everything a search allocates --- node arena, frontiers and repeat-tracking tables
+       a batch keeps one context alive and hands it to every solve, so the memory is reused instead of being reallocated per puzzle
+       the goal table is cached too: consecutive puzzles with the same goal skip record_goal_positions
+    */
+
+    node_arena<N> arena;
+    heap_frontier heap_open;
+    bucket_frontier bucket_open;
+
+    // WE NEED THIS SINCE WE'RE DOING A GRAPH SEARCH SO IT HELPS US TRACK REPEATS
+    state_table<N> states; // every reached board (packed) --> the node holding it, and whether that node is explored or in the frontier
+
+    // the backward half of a bidirectional search (searching from the goal toward the start) --- the forward half uses the members above
+    heap_frontier backward_heap_open;
+    bucket_frontier backward_bucket_open;
+    state_table<N> backward_states;
+
+    bool has_goal = false;
+    board_key<N> goal_key = 0; // packed goal the cached `gps` belongs to
+    goal_positions<N> gps;
+
+    const goal_positions<N>& goal_table(const state<N>& goal_state){ // goal positions for `goal_state`, rebuilt only when the goal changes
+        if(!has_goal || goal_key != goal_state.packed){
+            gps = record_goal_positions<N>(goal_state.board);
+            goal_key = goal_state.packed;
+            has_goal = true;
+        }
+        return gps;
+    }
+
+}; // end of search_context struct definition
+
+
+template<int N, typename Frontier>
+static uint32_t a_star_search(const state<N>& initial_state, const state<N>& goal_state, int heuristic_choice, Frontier& frontier, search_context<N>& context, search_stats& stats){ // start of a_star_search function definition
+    
+    /* the returned node id (NO_NODE when there is no solution) lives in context.arena, which stays valid until the context's next search */
+
+    const goal_positions<N>& gps = context.goal_table(goal_state); // record the goal positions for each tile
+
+
+    // INITIALIZE FRONTIER --- FRONTIER hands back the entry with the lowest f value first (heap_frontier or bucket_frontier)
+       // decrease-key is done lazily: an improved node gets a new entry and its older entries are skipped when popped
+    frontier.clear();
+
+    node_arena<N>& arena = context.arena;
+    state_table<N>& states = context.states;
+    arena.reset();
+    states.clear();
+
+
+
+    
+    // creating the root node
+    uint32_t root_id = arena.allocate();
+    Node<N>* root_node = &arena[root_id];
+    root_node->s = initial_state;
+    root_node-> g = 0;
+    root_node->h = evaluate_heuristic(initial_state.board, gps, heuristic_choice, root_node->h_manhattan, root_node->h_conflicts); // heuristic depends on what the user chose
+    root_node->f = root_node->g + root_node->h;
+    root_node->move = '\0'; 
+    root_node->parent = NO_NODE;
+    
+    // adding the root node (aka initial node) to the frontier --- get things started
+    frontier.push({root_node->f, root_node->g, root_id});
+    states.insert(initial_state.packed, root_id);
+    ++stats.nodes_generated;
+
+
+
+    search_trace& trace = stats.trace;
+    trace.mark_recorded();
+    trace.count(TRACE_FRONTIER_PUSHES); // the root
+    trace.observe_frontier(frontier.size());
+
+    // CORE A* SEARCH LOOP
+    while(!frontier.empty()){ // start of the core A* search loop
+
+        // grab the node with the lowest f value from the frontier
+        frontier_entry current_entry;
+        {trace_timer timer(trace, TRACE_QUEUE); current_entry = frontier.pop();}
+        trace.count(TRACE_FRONTIER_POPS);
+        uint32_t current_id = current_entry.id;
+        Node<N>* current_node = &arena[current_id];
+
+        if(current_entry.f != current_node->f){++stats.stale_entries; continue;} // STALE ENTRY --- this node was improved after the entry was pushed, its current entry is elsewhere in the heap
+
+        if(is_goal_state(current_node->s, goal_state)){return current_id;} // GOAL TEST --- did we find the goal state?
+
+        
+        {trace_timer timer(trace, TRACE_HASHING); states.close(*states.find(current_node->s.packed));} // move the current node from the frontier to the explored set
+        ++stats.nodes_expanded;
+
+        successor_list<N> children;
+        generate_children(current_node->s, current_node->move, children); // GENERATE CHILDREN NODES (AKA NEXT ACTION NODES)
+
+        for(const auto& [move, next_state] : children){ // start of processing each child node
+
+            board_key<N> child_state_key = next_state.packed;
+
+            int child_g = current_node->g + 1; // path cost --- cost from the initial state to the current state
+
+            uint32_t* reached;
+            {trace_timer timer(trace, TRACE_HASHING); reached = states.find(child_state_key);}
+            if(reached != nullptr && state_table<N>::is_closed(*reached)){
+
+                // reaching here means that this child node's state has already been explored
+                // with a consistent heuristic the explored node always has the cheaper path, but h2 is not guaranteed consistent
+                   // so if we did find a cheaper path we re-open the explored node to keep the solution optimal
+
+                uint32_t explored_id = state_table<N>::node_of(*reached);
+                Node<N>* explored_node = &arena[explored_id];
+                if(child_g >= explored_node->g){trace.count(TRACE_DUPLICATE_HITS); continue;} // skip this child node's state --- the explored path is at least as cheap
+
+                explored_node->g = child_g;
+                explored_node->f = child_g + explored_node->h; // h only depends on the board, which is unchanged
+                explored_node->move = move;
+                explored_node->parent = current_id;
+
+                {trace_timer timer(trace, TRACE_QUEUE); frontier.push({explored_node->f, explored_node->g, explored_id});}
+                states.reopen(*reached, explored_id);
+                trace.count(TRACE_FRONTIER_PUSHES);
+                trace.observe_frontier(frontier.size());
+                ++stats.nodes_reopened;
+                continue;
+            }
+            
+            if(reached != nullptr){
+
+                // reaching here means that this child node's state is already in the frontier
+                // we need to check if the child node's f value is less than the f value of the node in the frontier with the same state
+                   // both share the same board and therefore the same h, so comparing f comes down to comparing g
+                
+                uint32_t existing_id = *reached;
+                Node<N>* existing_node = &arena[existing_id];
+                int child_f = child_g + existing_node->h;
+                if(child_f < existing_node->f){
+                    // update the existing node in the frontier with better costs
+                    existing_node->g = child_g;
+                    existing_node->f = child_f;
+                    existing_node->move = move;
+                    existing_node->parent = current_id;
+
+                    {trace_timer timer(trace, TRACE_QUEUE); frontier.push({child_f, child_g, existing_id});} // DECREASE-KEY --- push a fresh entry, the old one is now stale
+                    trace.count(TRACE_DECREASE_KEYS);
+                    trace.count(TRACE_FRONTIER_PUSHES);
+                    trace.observe_frontier(frontier.size());
+                }
+            }
+            else{
+               
+                // reaching here means that this child node's state is NOT in the frontier yet
+                
+                // creating the child node
+                uint32_t child_id = arena.allocate();
+                Node<N>* child_node = &arena[child_id];
+                child_node->s = next_state;
+                child_node->g = child_g;
+                {trace_timer timer(trace, TRACE_HEURISTIC); child_node->h = evaluate_heuristic_after_move(current_node->s, next_state, gps, heuristic_choice, current_node->h_manhattan, current_node->h_conflicts, child_node->h_manhattan, child_node->h_conflicts);} // computing child's costs (g, h and ultimately f)
+                child_node->f = child_g + child_node->h;
+                int child_f = child_node->f;
+                child_node->move = move;
+                child_node->parent = current_id;
+
+
+                // adding the child node to the frontier
+                {trace_timer timer(trace, TRACE_QUEUE); frontier.push({child_f, child_g, child_id});}
+                {trace_timer timer(trace, TRACE_HASHING); states.insert(child_state_key, child_id);}
+                trace.count(TRACE_FRONTIER_PUSHES);
+                trace.observe_frontier(frontier.size());
+                ++stats.nodes_generated;
+
+            }
+
+        } // end of processing each child node
+
+    } // end of the core A* search loop
+    
+    return NO_NODE; // no solution found
+
+} // end of a_star_search function definition
+
+
+template<int N>
+static uint32_t a_star_search(const state<N>& initial_state, const state<N>& goal_state, int heuristic_choice, frontier_kind frontier_choice, search_context<N>& context, search_stats& stats){ // start of a_star_search dispatch definition
+    
+    /* picks the frontier implementation the user asked for */
+
+    if(frontier_choice == FRONTIER_BUCKET){return a_star_search(initial_state, goal_state, heuristic_choice, context.bucket_open, context, stats);}
+    return a_star_search(initial_state, goal_state, heuristic_choice, context.heap_open, context, stats);
+
+} // end of a_star_search dispatch definition
+
+
+
+
+                                                     /* =============================================== BATCHED HEURISTIC KERNELS =============================================== */
+
+/*
+   h1/h2 for a whole batch of boards (every child of an expansion) straight from their packed keys --- no board grid is touched
+   only the nibble-packed sizes (3x3, 4x4) have kernels; the 24-puzzle keeps the scalar heuristics above
+
+   each tile is first relabeled to its goal cell (one byte shuffle), which makes everything after it goal-independent:
+      Manhattan is two more shuffles (label -> goal row, label -> goal column) against the rows and columns of the cells themselves
+      linear conflicts are table lookups: a line's N labels packed into 4N bits index a precomputed conflict count for that line
+   the blank is given the label of a cell on neither of its lines, so the conflict tables never take it for a tile at home
+
+   the SIMD versions are picked at runtime: AVX2 (two boards per register), else SSE4.2, else a plain scalar loop
+*/
+
+template<int N>
+struct kernel_layout{ // start of kernel_layout struct definition
+
+    /* per-lane constants of the kernels, one byte per cell (lanes past the last cell stay zero) */
+
+    alignas(16) uint8_t cell_rows[16];    // row of each cell
+    alignas(16) uint8_t cell_cols[16];    // column of each cell
+    alignas(16) uint8_t label_rows[16];   // goal row of each label (= row of that cell)
+    alignas(16) uint8_t label_cols[16];   // goal column of each label
+    alignas(16) uint8_t transpose[16];    // shuffle from row-major to column-major lanes (0x80 zeroes unused lanes)
+    alignas(16) uint8_t blank_labels[16]; // label given to the blank at each cell: the cell one row down and one column right, wrapping
+
+}; // end of kernel_layout struct definition
+
+
+template<int N>
+static constexpr kernel_layout<N> build_kernel_layout(){ // start of build_kernel_layout function definition
+
+    kernel_layout<N> layout{};
+    for(int cell = 0; cell < 16; ++cell){layout.transpose[cell] = 0x80;}
+
+    for(int cell = 0; cell < 16; ++cell){
+
+        layout.label_rows[cell] = static_cast<uint8_t>(cell / N);
+        layout.label_cols[cell] = static_cast<uint8_t>(cell % N);
+        if(cell >= N * N){continue;}
+
+        int row = cell / N, col = cell % N;
+        layout.cell_rows[cell] = static_cast<uint8_t>(row);
+        layout.cell_cols[cell] = static_cast<uint8_t>(col);
+        layout.transpose[col * N + row] = static_cast<uint8_t>(cell);
+        layout.blank_labels[cell] = static_cast<uint8_t>(((row + 1) % N) * N + (col + 1) % N);
+
+    }
+    return layout;
+
+} // end of build_kernel_layout function definition
+
+template<int N>
+static constexpr kernel_layout<N> KERNEL_LAYOUT = build_kernel_layout<N>();
+
+
+template<int N>
+struct line_conflict_tables{ // start of line_conflict_tables struct definition
+
+    /*
+       the linear conflicts of every possible line of labels: rows[row << LINE_BITS | line], cols[col << LINE_BITS | line]
+       a line holds N 4-bit labels, first cell in the lowest bits --- 4096 entries per line for 3x3, 65536 for 4x4
+       labels are goal cells, so one set of tables serves every goal
+    */
+
+    static constexpr int LINE_BITS = 4 * N;
+    static constexpr uint64_t LINE_MASK = (uint64_t(1) << LINE_BITS) - 1;
+
+    vector<uint8_t> rows;
+    vector<uint8_t> cols;
+
+}; // end of line_conflict_tables struct definition
+
+
+template<int N>
+static const line_conflict_tables<N>& conflict_tables(){ // start of conflict_tables function definition
+
+    /* the tables for this board size, built on first use (a function-local static, so concurrent HDA* workers build it once) */
+
+    static const line_conflict_tables<N> tables = [](){
+
+        line_conflict_tables<N> built;
+        const size_t entries = size_t(1) << line_conflict_tables<N>::LINE_BITS;
+        built.rows.assign(N * entries, 0);
+        built.cols.assign(N * entries, 0);
+
+        for(int line = 0; line < N; ++line){
+            for(size_t contents = 0; contents < entries; ++contents){
+
+                int row_conflicts = 0, col_conflicts = 0;
+                for(int i = 0; i < N; ++i){
+
+                    int first = (contents >> (4 * i)) & 0xF;
+                    if(first >= N * N){continue;} // label never produced for this size
+
+                    for(int j = i + 1; j < N; ++j){
+                        int second = (contents >> (4 * j)) & 0xF;
+                        if(second >= N * N){continue;}
+
+                        // same pairs wrong_ordering_counter counts: both tiles home in this line, goal order reversed
+                        if(first / N == line && second / N == line && first % N > second % N){++row_conflicts;}
+                        if(first % N == line && second % N == line && first / N > second / N){++col_conflicts;}
+                    }
+                }
+                built.rows[line * entries + contents] = static_cast<uint8_t>(row_conflicts);
+                built.cols[line * entries + contents] = static_cast<uint8_t>(col_conflicts);
+
+            }
+        }
+        return built;
+
+    }();
+    return tables;
+
+} // end of conflict_tables function definition
+
+
+template<int N>
+static int table_linear_conflicts(const line_conflict_tables<N>& tables, uint64_t row_labels, uint64_t col_labels){ // start of table_linear_conflicts function definition
+
+    /* linear conflicts of a relabeled board: row_labels holds the labels in row-major order, col_labels in column-major order */
+
+    constexpr int LINE_BITS = line_conflict_tables<N>::LINE_BITS;
+    int conflicts = 0;
+    for(int line = 0; line < N; ++line){
+        conflicts += tables.rows[(size_t(line) << LINE_BITS) | ((row_labels >> (line * LINE_BITS)) & line_conflict_tables<N>::LINE_MASK)];
+        conflicts += tables.cols[(size_t(line) << LINE_BITS) | ((col_labels >> (line * LINE_BITS)) & line_conflict_tables<N>::LINE_MASK)];
+    }
+    return conflicts;
+
+} // end of table_linear_conflicts function definition
+
+
+template<int N>
+using heuristic_kernel = void (*)(const board_key<N>* keys, const int* blank_cells, int count, const goal_positions<N>& gps, bool with_conflicts, int* h_values);
+
+
+template<int N>
+static void score_boards_scalar(const board_key<N>* keys, const int* blank_cells, int count, const goal_positions<N>& gps, bool with_conflicts, int* h_values){ // start of score_boards_scalar function definition
+
+    /* portable fallback: the same relabeling and table lookups, one cell at a time */
+
+    const kernel_layout<N>& layout = KERNEL_LAYOUT<N>;
+    const line_conflict_tables<N>& tables = conflict_tables<N>();
+
+    for(int each_board = 0; each_board < count; ++each_board){
+
+        uint64_t row_labels = 0, col_labels = 0;
+        int manhattan = 0;
+
+        for(int cell = 0; cell < N * N; ++cell){
+            int tile_value = static_cast<int>((keys[each_board] >> (4 * cell)) & 0xF);
+            int label = (tile_value == 0) ? layout.blank_labels[blank_cells[each_board]] : gps.goal_cells[tile_value];
+
+            row_labels |= uint64_t(label) << (4 * cell);
+            col_labels |= uint64_t(label) << (4 * ((cell % N) * N + cell / N));
+            if(tile_value != 0){manhattan += abs(label / N - cell / N) + abs(label % N - cell % N);}
+        }
+
+        h_values[each_board] = manhattan + (with_conflicts ? 2 * table_linear_conflicts<N>(tables, row_labels, col_labels) : 0);
+
+    }
+
+} // end of score_boards_scalar function definition
+
+
+#if defined(__x86_64__)
+
+template<int N>
+__attribute__((target("sse4.2")))
+static void score_boards_sse42(const board_key<N>* keys, const int* blank_cells, int count, const goal_positions<N>& gps, bool with_conflicts, int* h_values){ // start of score_boards_sse42 function definition
+
+    /*
+       one board per 128-bit register, one cell per byte lane:
+          nibbles -> bytes, shuffle tile -> label, shuffle label -> goal row/column, |difference| per lane, psadbw to sum the lanes
+          the labels are packed back into nibbles (maddubs + packus) to index the conflict tables
+    */
+
+    const kernel_layout<N>& layout = KERNEL_LAYOUT<N>;
+    const line_conflict_tables<N>& tables = conflict_tables<N>();
+
+    alignas(16) uint8_t relabel_bytes[16] = {};
+    memcpy(relabel_bytes, gps.goal_cells.data(), N * N);
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i low_nibbles = _mm_set1_epi8(0x0F);
+    const __m128i nibble_pairs = _mm_set1_epi16(0x1001); // lane 2i * 1 + lane 2i+1 * 16
+    const __m128i relabel = _mm_load_si128(reinterpret_cast<const __m128i*>(relabel_bytes));
+    const __m128i cell_rows = _mm_load_si128(reinterpret_cast<const __m128i*>(layout.cell_rows));
+    const __m128i cell_cols = _mm_load_si128(reinterpret_cast<const __m128i*>(layout.cell_cols));
+    const __m128i label_rows = _mm_load_si128(reinterpret_cast<const __m128i*>(layout.label_rows));
+    const __m128i label_cols = _mm_load_si128(reinterpret_cast<const __m128i*>(layout.label_cols));
+    const __m128i transpose = _mm_load_si128(reinterpret_cast<const __m128i*>(layout.transpose));
+
+    for(int each_board = 0; each_board < count; ++each_board){
+
+        __m128i packed = _mm_cvtsi64_si128(static_cast<long long>(keys[each_board]));
+        __m128i tiles = _mm_unpacklo_epi8(_mm_and_si128(packed, low_nibbles), _mm_and_si128(_mm_srli_epi16(packed, 4), low_nibbles));
+        __m128i labels = _mm_shuffle_epi8(_mm_insert_epi8(relabel, layout.blank_labels[blank_cells[each_board]], 0), tiles);
+
+        __m128i distances = _mm_add_epi8(_mm_abs_epi8(_mm_sub_epi8(_mm_shuffle_epi8(label_rows, labels), cell_rows)),
+                                         _mm_abs_epi8(_mm_sub_epi8(_mm_shuffle_epi8(label_cols, labels), cell_cols)));
+        distances = _mm_andnot_si128(_mm_cmpeq_epi8(tiles, zero), distances); // the blank (and lanes past the board) add nothing
+        __m128i sums = _mm_sad_epu8(distances, zero);
+        int manhattan = _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
+
+        if(!with_conflicts){h_values[each_board] = manhattan; continue;}
+
+        uint64_t row_labels = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_packus_epi16(_mm_maddubs_epi16(labels, nibble_pairs), zero)));
+        uint64_t col_labels = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_packus_epi16(_mm_maddubs_epi16(_mm_shuffle_epi8(labels, transpose), nibble_pairs), zero)));
+        h_values[each_board] = manhattan + 2 * table_linear_conflicts<N>(tables, row_labels, col_labels);
+
+    }
+
+} // end of score_boards_sse42 function definition
+
+
+template<int N>
+__attribute__((target("avx2")))
+static void score_boards_avx2(const board_key<N>* keys, const int* blank_cells, int count, const goal_positions<N>& gps, bool with_conflicts, int* h_values){ // start of score_boards_avx2 function definition
+
+    /* score_boards_sse42 with two boards per 256-bit register --- every shuffle stays inside its 128-bit half, so each half is one board */
+
+    const kernel_layout<N>& layout = KERNEL_LAYOUT<N>;
+    const line_conflict_tables<N>& tables = conflict_tables<N>();
+
+    alignas(16) uint8_t relabel_bytes[16] = {};
+    memcpy(relabel_bytes, gps.goal_cells.data(), N * N);
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+    const __m256i nibble_pairs = _mm256_set1_epi16(0x1001);
+    const __m128i relabel = _mm_load_si128(reinterpret_cast<const __m128i*>(relabel_bytes));
+    const __m256i cell_rows = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(layout.cell_rows)));
+    const __m256i cell_cols = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(layout.cell_cols)));
+    const __m256i label_rows = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(layout.label_rows)));
+    const __m256i label_cols = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(layout.label_cols)));
+    const __m256i transpose = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(layout.transpose)));
+
+    for(int each_board = 0; each_board < count; each_board += 2){
+
+        int second = (each_board + 1 < count) ? each_board + 1 : each_board; // an odd batch scores its last board twice
+        __m256i packed = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_cvtsi64_si128(static_cast<long long>(keys[each_board]))),
+                                                 _mm_cvtsi64_si128(static_cast<long long>(keys[second])), 1);
+        __m256i relabels = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_insert_epi8(relabel, layout.blank_labels[blank_cells[each_board]], 0)),
+                                                   _mm_insert_epi8(relabel, layout.blank_labels[blank_cells[second]], 0), 1);
+
+        __m256i tiles = _mm256_unpacklo_epi8(_mm256_and_si256(packed, low_nibbles), _mm256_and_si256(_mm256_srli_epi16(packed, 4), low_nibbles));
+        __m256i labels = _mm256_shuffle_epi8(relabels, tiles);
+
+        __m256i distances = _mm256_add_epi8(_mm256_abs_epi8(_mm256_sub_epi8(_mm256_shuffle_epi8(label_rows, labels), cell_rows)),
+                                            _mm256_abs_epi8(_mm256_sub_epi8(_mm256_shuffle_epi8(label_cols, labels), cell_cols)));
+        distances = _mm256_andnot_si256(_mm256_cmpeq_epi8(tiles, zero), distances);
+        __m256i sums = _mm256_sad_epu8(distances, zero);
+        int manhattan[2] = {static_cast<int>(_mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1)),
+                            static_cast<int>(_mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3))};
+
+        if(with_conflicts){
+            __m256i row_labels = _mm256_packus_epi16(_mm256_maddubs_epi16(labels, nibble_pairs), zero);
+            __m256i col_labels = _mm256_packus_epi16(_mm256_maddubs_epi16(_mm256_shuffle_epi8(labels, transpose), nibble_pairs), zero);
+            manhattan[0] += 2 * table_linear_conflicts<N>(tables, static_cast<uint64_t>(_mm256_extract_epi64(row_labels, 0)), static_cast<uint64_t>(_mm256_extract_epi64(col_labels, 0)));
+            manhattan[1] += 2 * table_linear_conflicts<N>(tables, static_cast<uint64_t>(_mm256_extract_epi64(row_labels, 2)), static_cast<uint64_t>(_mm256_extract_epi64(col_labels, 2)));
+        }
+
+        h_values[each_board] = manhattan[0];
+        if(second != each_board){h_values[second] = manhattan[1];}
+
+    }
+
+} // end of score_boards_avx2 function definition
+
+#endif
+
+
+template<int N>
+static heuristic_kernel<N> select_heuristic_kernel(){ // start of select_heuristic_kernel function definition
+
+    /* the widest kernel this CPU runs */
+
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){return score_boards_avx2<N>;}
+    if(__builtin_cpu_supports("sse4.2")){return score_boards_sse42<N>;}
+#endif
+    return score_boards_scalar<N>;
+
+} // end of select_heuristic_kernel function definition
+
+
+template<int N>
+static void score_boards(const board_key<N>* keys, const int* blank_cells, int count, const goal_positions<N>& gps, bool with_conflicts, int* h_values){ // start of score_boards function definition
+
+    /*
+       h1 (with_conflicts false) or h2 of `count` packed boards, blank_cells[i] being the blank's cell in keys[i] --- 3x3 and 4x4 only
+       the kernel is chosen once, on the first call
+    */
+
+    static const heuristic_kernel<N> kernel = select_heuristic_kernel<N>();
+    kernel(keys, blank_cells, count, gps, with_conflicts, h_values);
+
+} // end of score_boards function definition
+
+
+
+
+                                                     /* =============================================== IDA* SEARCH ALGORITHM =============================================== */
+
+
+const int IDA_STAR_FOUND = -1; // returned by ida_star_probe when the goal was reached
+
+template<int N>
+struct ida_star_search_state{ // start of ida_star_search_state struct definition
+
+    /*
+       everything one IDA* search shares across its recursion
+       there is exactly ONE board (`current`): moves are made on it going down and slid back coming up,
+          so memory is the board plus the path --- O(depth), no matter how many nodes are visited
+    */
+
+    state<N> current;
+    const state<N>* goal_state;
+    const goal_positions<N>* gps;
+    int heuristic_choice;
+
+    vector<char> path_actions; // actions from the root to `current`
+    vector<int> path_fvalues;  // f values of the nodes from the root to `current`
+    search_stats* stats;
+
+}; // end of ida_star_search_state struct definition
+
+
+template<int N>
+static int ida_star_probe(ida_star_search_state<N>& search, int g, int h, int manhattan, int conflicts, int bound, char parent_move){ // start of ida_star_probe function definition
+    
+    /*
+       depth-first search below `search.current` (reached with cost g), cut off at nodes whose f exceeds `bound`
+       returns IDA_STAR_FOUND when the goal was reached (the path is left in search.path_*),
+          otherwise the smallest f that was cut off --- the bound for the next iteration (INT_MAX when nothing was cut off)
+    */
+
+    int f = g + h;
+    if(f > bound){return f;}
+    if(is_goal_state(search.current, *search.goal_state)){return IDA_STAR_FOUND;} // GOAL TEST
+
+    ++search.stats->nodes_expanded;
+    int smallest_cut_off = INT_MAX;
+    int blank_row = search.current.blank_s_row;
+    int blank_col = search.current.blank_s_col;
+    char undo_move = inverse_move(parent_move);
+
+    const move_table_row& legal_moves = MOVE_TABLE<N>[blank_row * N + blank_col];
+
+    if constexpr(board_traits<N>::TILE_BITS == 4){ // start of scoring the children as one batch (3x3, 4x4 with h1/h2)
+        if(search.heuristic_choice != 3){
+
+            /*
+               the children's keys are built from the parent's key alone and scored together by the batched kernel
+               children over the bound are cut off right here, so the board is only touched for the ones actually descended into
+            */
+
+            const board_key<N> packed = search.current.packed;
+            const int blank_cell = blank_row * N + blank_col;
+
+            board_key<N> child_keys[4];
+            int child_blanks[4], child_h[4];
+            char child_actions[4];
+            int child_count = 0;
+
+            for(int each_option = 0; each_option < legal_moves.count; ++each_option){
+                const move_option& option = legal_moves.options[each_option];
+                if(option.action == undo_move){continue;} // going straight back to the parent
+
+                child_keys[child_count] = slide_key<N>(packed, blank_cell, option.target_cell);
+                child_blanks[child_count] = option.target_cell;
+                child_actions[child_count] = option.action;
+                ++child_count;
+            }
+
+            score_boards<N>(child_keys, child_blanks, child_count, *search.gps, search.heuristic_choice == 2, child_h);
+
+            for(int each_child = 0; each_child < child_count; ++each_child){
+
+                ++search.stats->nodes_generated; // counted as reached, like the loop below, so children after the goal's branch don't count
+                int child_f = g + 1 + child_h[each_child];
+                if(child_f > bound){smallest_cut_off = min(smallest_cut_off, child_f); continue;} // what probing it would return
+
+                make_move(search.current, child_blanks[each_child]); // MAKE
+                search.path_actions.push_back(child_actions[each_child]);
+                search.path_fvalues.push_back(child_f);
+
+                int result = ida_star_probe(search, g + 1, child_h[each_child], 0, 0, bound, child_actions[each_child]);
+                if(result == IDA_STAR_FOUND){return IDA_STAR_FOUND;} // leave the path in place for the caller
+
+                search.path_actions.pop_back();
+                search.path_fvalues.pop_back();
+                make_move(search.current, blank_cell); // UNMAKE --- slide the tile back
+
+                smallest_cut_off = min(smallest_cut_off, result);
+
+            }
+            return smallest_cut_off;
+
+        }
+    } // end of scoring the children as one batch
+
+    for(int each_option = 0; each_option < legal_moves.count; ++each_option){ // start of processing each child
+
+        const move_option& option = legal_moves.options[each_option];
+        if(option.action == undo_move){continue;} // going straight back to the parent
+
+        int tile_row = option.target_cell / N; // the tile that slides into the blank
+        int tile_col = option.target_cell % N;
+
+        // child's h from the parent's parts (same deltas as evaluate_heuristic_after_move), with the move made in place
+        int child_manhattan = 0, child_conflicts = conflicts, child_h;
+        if(search.heuristic_choice == 3){
+            make_move(search.current, option.target_cell);
+            child_h = heuristic_h3(search.current.board, *search.gps);
+        }
+        else{
+            int tile_value = search.current.board[tile_row][tile_col];
+            child_manhattan = manhattan + slide_manhattan_delta(tile_value, tile_row, tile_col, blank_row, blank_col, *search.gps);
+
+            if(search.heuristic_choice == 2){child_conflicts -= slide_line_conflicts(search.current.board, *search.gps, tile_row, tile_col, blank_row, blank_col);}
+            make_move(search.current, option.target_cell); // MAKE
+            if(search.heuristic_choice == 2){child_conflicts += slide_line_conflicts(search.current.board, *search.gps, tile_row, tile_col, blank_row, blank_col);}
+
+            child_h = child_manhattan + 2 * child_conflicts;
+        }
+        ++search.stats->nodes_generated;
+
+        search.path_actions.push_back(option.action);
+        search.path_fvalues.push_back(g + 1 + child_h);
+
+        int result = ida_star_probe(search, g + 1, child_h, child_manhattan, child_conflicts, bound, option.action);
+        if(result == IDA_STAR_FOUND){return IDA_STAR_FOUND;} // leave the path in place for the caller
+
+        search.path_actions.pop_back();
+        search.path_fvalues.pop_back();
+        make_move(search.current, blank_row * N + blank_col); // UNMAKE --- slide the tile back
+
+        smallest_cut_off = min(smallest_cut_off, result);
+
+    } // end of processing each child
+
+    return smallest_cut_off;
+
+} // end of ida_star_probe function definition
+
+
+template<int N>
+static bool ida_star_search(const state<N>& initial_state, const state<N>& goal_state, int heuristic_choice, search_stats& stats, vector<char>& actions, vector<int>& fvalues){ // start of ida_star_search function definition
+    
+    /*
+       iterative-deepening A*: repeated depth-first probes with an f bound that starts at h(root)
+          and is raised to the smallest f that was cut off, until a probe reaches the goal
+       with an admissible heuristic the first path found is optimal
+
+       fills `actions`/`fvalues` exactly like reconstruct_solution does; nodes_generated counts every child generated over all iterations
+       returns false if there is no solution
+    */
+
+    goal_positions<N> gps = record_goal_positions<N>(goal_state.board);
+
+    ida_star_search_state<N> search;
+    search.current = initial_state;
+    search.goal_state = &goal_state;
+    search.gps = &gps;
+    search.heuristic_choice = heuristic_choice;
+    search.stats = &stats;
+
+    int root_manhattan, root_conflicts;
+    int root_h = evaluate_heuristic(initial_state.board, gps, heuristic_choice, root_manhattan, root_conflicts);
+    ++stats.nodes_generated; // the root
+
+    int bound = root_h;
+    while(true){ // start of each iteration
+
+        search.path_actions.clear();
+        search.path_fvalues.assign(1, root_h); // the root's f value (g = 0)
+
+        int result = ida_star_probe(search, 0, root_h, root_manhattan, root_conflicts, bound, '\0');
+        if(result == IDA_STAR_FOUND){break;}
+        if(result == INT_MAX){return false;} // nothing was cut off --- the whole reachable space was searched
+
+        bound = result;
+
+    } // end of each iteration
+
+    actions = search.path_actions;
+    fvalues = search.path_fvalues;
+    return true;
+
+} // end of ida_star_search function definition
+
+
+
+
+                                                     /* =============================================== BIDIRECTIONAL SEARCH ALGORITHM =============================================== */
+
+
+template<int N, typename Frontier>
+struct bidirectional_side{ // start of bidirectional_side struct definition
+
+    /*
+       one direction of a bidirectional search: its frontier, its repeat-tracking tables and the goal table its heuristic aims at
+       the forward side aims at the goal state, the backward side aims at the initial state --- both sides allocate from the same node_arena
+    */
+
+    Frontier* open;
+    state_table<N>* states;
+    goal_positions<N> gps; // positions of the tiles at the far end of this side
+
+    bool has_next = false;   // `next` holds the side's best valid frontier entry, popped but not yet expanded
+    frontier_entry next{};
+
+}; // end of bidirectional_side struct definition
+
+
+template<int N>
+static int meet_in_the_middle_priority(const Node<N>& node){ // start of meet_in_the_middle_priority function definition
+    
+    /*
+       MM's priority: max(f, 2g) --- the 2g term stops either side from expanding a node past the midpoint of a path before the other side has caught up
+       it grows strictly with g (h is fixed per board), so a node's frontier entry is stale exactly when its stored priority no longer matches
+    */
+
+    return max(node.f, 2 * node.g);
+
+} // end of meet_in_the_middle_priority function definition
+
+
+template<int N, typename Frontier>
+static void expand_bidirectional_side(bidirectional_side<N, Frontier>& side, bidirectional_side<N, Frontier>& other_side, bool forward, int heuristic_choice, node_arena<N>& arena, search_stats& stats, int& best_cost, uint32_t& forward_meeting_id, uint32_t& backward_meeting_id){ // start of expand_bidirectional_side function definition
+    
+    /*
+       expands the node in side.next: the same child handling as a_star_search (re-open explored nodes, decrease-key frontier nodes, create new ones)
+       every child that got a new or cheaper g is looked up on the other side --- a hit is a full start-to-goal path, and the cheapest one is kept in best_cost
+    */
+
+    uint32_t current_id = side.next.id;
+    side.has_next = false;
+    Node<N>* current_node = &arena[current_id];
+
+    side.states->close(*side.states->find(current_node->s.packed));
+    ++stats.nodes_expanded;
+
+    successor_list<N> children;
+    generate_children(current_node->s, current_node->move, children);
+
+    for(const auto& [move, next_state] : children){ // start of processing each child node
+
+        board_key<N> child_state_key = next_state.packed;
+        int child_g = current_node->g + 1;
+        uint32_t child_id;
+
+        uint32_t* reached = side.states->find(child_state_key);
+        if(reached != nullptr && state_table<N>::is_closed(*reached)){
+
+            // already explored on this side --- re-open it only if this path is cheaper (see a_star_search)
+            child_id = state_table<N>::node_of(*reached);
+            Node<N>* explored_node = &arena[child_id];
+            if(child_g >= explored_node->g){continue;}
+
+            explored_node->g = child_g;
+            explored_node->f = child_g + explored_node->h;
+            explored_node->move = move;
+            explored_node->parent = current_id;
+
+            side.open->push({meet_in_the_middle_priority(*explored_node), child_g, child_id});
+            side.states->reopen(*reached, child_id);
+            ++stats.nodes_reopened;
+        }
+        else if(reached != nullptr){
+
+            // already in this side's frontier --- DECREASE-KEY if this path is cheaper
+            child_id = *reached;
+            Node<N>* existing_node = &arena[child_id];
+            if(child_g >= existing_node->g){continue;}
+
+            existing_node->g = child_g;
+            existing_node->f = child_g + existing_node->h;
+            existing_node->move = move;
+            existing_node->parent = current_id;
+
+            side.open->push({meet_in_the_middle_priority(*existing_node), child_g, child_id});
+        }
+        else{
+
+            // never seen on this side --- create the child node
+            child_id = arena.allocate();
+            Node<N>* child_node = &arena[child_id];
+            child_node->s = next_state;
+            child_node->g = child_g;
+            child_node->h = evaluate_heuristic_after_move(current_node->s, next_state, side.gps, heuristic_choice, current_node->h_manhattan, current_node->h_conflicts, child_node->h_manhattan, child_node->h_conflicts);
+            child_node->f = child_g + child_node->h;
+            child_node->move = move;
+            child_node->parent = current_id;
+
+            side.open->push({meet_in_the_middle_priority(*child_node), child_g, child_id});
+            side.states->insert(child_state_key, child_id);
+            ++stats.nodes_generated;
+        }
+
+        // MEETING TEST --- has the other side already reached this board?
+        uint32_t* other_reached = other_side.states->find(child_state_key);
+        if(other_reached == nullptr){continue;}
+
+        uint32_t other_id = state_table<N>::node_of(*other_reached);
+        int path_cost = child_g + arena[other_id].g;
+        if(path_cost < best_cost){
+            best_cost = path_cost;
+            forward_meeting_id = forward ? child_id : other_id;
+            backward_meeting_id = forward ? other_id : child_id;
+        }
+
+    } // end of processing each child node
+
+} // end of expand_bidirectional_side function definition
+
+
+template<int N, typename Frontier>
+static bool bidirectional_search(const state<N>& initial_state, const state<N>& goal_state, int heuristic_choice, Frontier& forward_open, Frontier& backward_open, search_context<N>& context, search_stats& stats, vector<char>& actions, vector<int>& fvalues){ // start of bidirectional_search function definition
+    
+    /*
+       MM bidirectional search (Holte et al.): A* forward from the initial state and backward from the goal, each side's heuristic aiming at the other end
+          the side whose best frontier entry has the lower priority max(f, 2g) is expanded next --- frontier entries carry that priority in their `f` slot
+       whenever the sides touch, the joined path's cost is a candidate U; once U is no larger than both sides' lowest priority C, no cheaper path exists
+          and the search stops with U optimal (the heuristics only need to be admissible)
+
+       the two half-paths are spliced into `actions`, and `fvalues` are the forward f values (g + h toward the goal) along the spliced path,
+          the same numbers A* would report for that path
+       returns false if there is no solution
+    */
+
+    node_arena<N>& arena = context.arena;
+    arena.reset();
+
+    bidirectional_side<N, Frontier> forward_side, backward_side;
+    forward_side.open = &forward_open;
+    forward_side.states = &context.states;
+    forward_side.gps = context.goal_table(goal_state);
+    backward_side.open = &backward_open;
+    backward_side.states = &context.backward_states;
+    backward_side.gps = record_goal_positions<N>(initial_state.board);
+
+    int best_cost = INT_MAX; // U --- cost of the cheapest start-to-goal path found so far
+    uint32_t forward_meeting_id = NO_NODE, backward_meeting_id = NO_NODE;
+
+    // creating both roots --- the initial state for the forward side, the goal state for the backward side
+    bidirectional_side<N, Frontier>* sides[2] = {&forward_side, &backward_side};
+    const state<N>* roots[2] = {&initial_state, &goal_state};
+    for(int each_side = 0; each_side < 2; ++each_side){
+        bidirectional_side<N, Frontier>& side = *sides[each_side];
+        side.open->clear();
+        side.states->clear();
+
+        uint32_t root_id = arena.allocate();
+        Node<N>* root_node = &arena[root_id];
+        root_node->s = *roots[each_side];
+        root_node->g = 0;
+        root_node->h = evaluate_heuristic(root_node->s.board, side.gps, heuristic_choice, root_node->h_manhattan, root_node->h_conflicts);
+        root_node->f = root_node->h;
+        root_node->move = '\0';
+        root_node->parent = NO_NODE;
+
+        side.open->push({meet_in_the_middle_priority(*root_node), 0, root_id});
+        side.states->insert(root_node->s.packed, root_id);
+        ++stats.nodes_generated;
+    }
+    if(initial_state.packed == goal_state.packed){ // the roots already meet
+        best_cost = 0;
+        forward_meeting_id = 0;
+        backward_meeting_id = 1;
+    }
+
+
+
+    // CORE MM SEARCH LOOP
+    while(true){ // start of the core MM search loop
+
+        // make sure each side has its best valid entry at hand --- stale entries are skipped as in a_star_search
+        for(bidirectional_side<N, Frontier>* side : sides){
+            while(!side->has_next && !side->open->empty()){
+                frontier_entry entry = side->open->pop();
+                if(entry.f != meet_in_the_middle_priority(arena[entry.id])){++stats.stale_entries; continue;}
+                side->next = entry;
+                side->has_next = true;
+            }
+        }
+
+        int forward_priority = forward_side.has_next ? forward_side.next.f : INT_MAX;
+        int backward_priority = backward_side.has_next ? backward_side.next.f : INT_MAX;
+        if(best_cost <= min(forward_priority, backward_priority)){break;} // TERMINATION TEST --- U <= C (also ends the search when both sides ran dry)
+
+        if(forward_priority <= backward_priority){expand_bidirectional_side(forward_side, backward_side, true, heuristic_choice, arena, stats, best_cost, forward_meeting_id, backward_meeting_id);}
+        else{expand_bidirectional_side(backward_side, forward_side, false, heuristic_choice, arena, stats, best_cost, forward_meeting_id, backward_meeting_id);}
+
+    } // end of the core MM search loop
+
+    if(best_cost == INT_MAX){return false;} // no solution found
+
+
+
+    // SPLICE THE HALF-PATHS: start --> meeting board comes off the forward tree, meeting board --> goal is the backward tree walked up with every move undone
+    for(uint32_t id = forward_meeting_id; arena[id].parent != NO_NODE; id = arena[id].parent){actions.push_back(arena[id].move);}
+    reverse(actions.begin(), actions.end());
+    for(uint32_t id = backward_meeting_id; arena[id].parent != NO_NODE; id = arena[id].parent){actions.push_back(inverse_move(arena[id].move));}
+
+    replay_fvalues(initial_state, actions, forward_side.gps, heuristic_choice, fvalues); // the forward f values along the spliced path
+    return true;
+
+} // end of bidirectional_search function definition
+
+
+
+
+                                                     /* =============================================== HDA* (HASH-DISTRIBUTED PARALLEL A*) =============================================== */
+
+
+const int HDA_LOCAL_BITS = 26; // a node id of HDA* is (owning worker << HDA_LOCAL_BITS) | id inside that worker's arena
+const uint32_t HDA_LOCAL_MASK = (1u << HDA_LOCAL_BITS) - 1;
+const int HDA_MAX_WORKERS = 1 << (31 - HDA_LOCAL_BITS); // keeps every global id below state_table's CLOSED_BIT
+const int HDA_EXPANSIONS_PER_ROUND = 64; // expansions between mailbox checks --- the outgoing batches are flushed after each round
+const int HDA_IDLE_SPINS = 64;          // empty mailbox checks an idle worker yields through before it starts sleeping between checks
+const int HDA_MAX_IDLE_SLEEP_US = 512;  // the sleep doubles from 8us up to this, so a long-idle worker costs next to no CPU
+
+template<int N>
+struct hda_message{ // a generated child on its way to the worker that owns its board --- h was computed by the sender, which still had the parent at hand
+    state<N> s;
+    int g;
+    int h;
+    int h_manhattan;
+    int h_conflicts;
+    char move;
+    uint32_t parent; // global id of the parent node (it may live in another worker's arena)
+};
+
+template<int N>
+struct hda_batch{ // messages travel between workers in batches, so the mailboxes are touched once per batch instead of once per child
+    vector<hda_message<N>> messages;
+    hda_batch* next; // next batch in the receiving mailbox
+};
+
+
+template<int N, typename Frontier>
+struct hda_worker{ // start of hda_worker struct definition
+
+    /* everything one HDA* thread owns: the nodes of its slice of the state space, their frontier and state table, and its incoming mailbox */
+
+    node_arena<N> arena;
+    Frontier open;
+    state_table<N> states;
+    atomic<hda_batch<N>*> mailbox{nullptr};   // lock-free stack of incoming batches: senders push with a CAS, the owner takes them all with one exchange
+    atomic<int> frontier_min{INT_MAX};        // lowest f in `open` or in a batch posted here (INT_MAX: nothing) --- the other workers expand nothing above it
+    vector<vector<hda_message<N>>> outgoing;  // [destination worker] children waiting to be sent
+    search_stats stats;
+
+}; // end of hda_worker struct definition
+
+
+struct hda_shared{ // start of hda_shared struct definition
+
+    /*
+       state shared by all HDA* workers
+
+       `pending_work` counts active workers plus batches posted but not yet processed; it is raised before the work it stands for can disappear
+          (a batch is counted before it is posted, an idle worker counts itself active again before it processes what it took),
+          so it reaches 0 only when every worker is idle with nothing left in flight --- the termination test
+       `best_cost` is U, the cheapest goal path found so far; nodes with f >= U are pruned, and once no worker holds a node with f < U, U is optimal
+    */
+
+    atomic<long long> pending_work{0};
+    atomic<int> best_cost{INT_MAX};
+    atomic<bool> out_of_ids{false}; // some worker's arena outgrew HDA_LOCAL_BITS --- every worker gives up
+    mutex incumbent_lock;           // guards best_cost updates together with best_id
+    uint32_t best_id = NO_NODE;     // global id of the goal node of the best path
+
+}; // end of hda_shared struct definition
+
+
+template<int N>
+static int hda_owner(board_key<N> key, int worker_count){ // start of hda_owner function definition
+    
+    /* the worker that owns `key` --- a different multiplier than state_table's so one worker's keys still spread over its whole table */
+
+    uint64_t folded = static_cast<uint64_t>(key) ^ static_cast<uint64_t>(key >> (sizeof(key) * 8 / 2) >> (sizeof(key) * 8 / 2));
+    return static_cast<int>(((folded * 0xC2B2AE3D27D4EB4Full) >> 32) % worker_count);
+
+} // end of hda_owner function definition
+
+
+template<int N, typename Frontier>
+static void hda_receive(hda_worker<N, Frontier>& worker, const hda_message<N>& message, hda_shared& shared){ // start of hda_receive function definition
+    
+    /* the owner's side of a generated child: the same re-open / decrease-key / new node handling as a_star_search, against this worker's table */
+
+    if(message.g + message.h >= shared.best_cost.load(memory_order_relaxed)){return;} // cannot beat the incumbent
+
+    uint32_t* reached = worker.states.find(message.s.packed);
+    if(reached != nullptr){
+        bool was_closed = state_table<N>::is_closed(*reached);
+        uint32_t local_id = state_table<N>::node_of(*reached);
+        Node<N>* existing_node = &worker.arena[local_id];
+        if(message.g >= existing_node->g){return;} // the known path is at least as cheap
+
+        existing_node->g = message.g;
+        existing_node->f = message.g + existing_node->h;
+        existing_node->move = message.move;
+        existing_node->parent = message.parent;
+        worker.open.push({existing_node->f, existing_node->g, local_id});
+        if(was_closed){worker.states.reopen(*reached, local_id); ++worker.stats.nodes_reopened;}
+        return;
+    }
+
+    uint32_t local_id = worker.arena.allocate();
+    if(local_id > HDA_LOCAL_MASK){shared.out_of_ids.store(true); return;}
+
+    Node<N>* child_node = &worker.arena[local_id];
+    child_node->s = message.s;
+    child_node->g = message.g;
+    child_node->h = message.h;
+    child_node->f = message.g + message.h;
+    child_node->h_manhattan = message.h_manhattan;
+    child_node->h_conflicts = message.h_conflicts;
+    child_node->move = message.move;
+    child_node->parent = message.parent;
+
+    worker.open.push({child_node->f, child_node->g, local_id});
+    worker.states.insert(message.s.packed, local_id);
+    ++worker.stats.nodes_generated;
+
+} // end of hda_receive function definition
+
+
+template<int N, typename Frontier>
+static void hda_post(vector<hda_worker<N, Frontier>>& workers, int destination, vector<hda_message<N>>& messages, hda_shared& shared){ // start of hda_post function definition
+    
+    /* hands `messages` to `destination`'s mailbox as one batch (lock-free push) and leaves `messages` empty */
+
+    hda_batch<N>* batch = new hda_batch<N>;
+    batch->messages.swap(messages);
+    shared.pending_work.fetch_add(1); // counted before the batch can be taken
+
+    int batch_min = INT_MAX; // lower the destination's published minimum first, so no worker runs ahead of these children while they are in flight
+    for(const hda_message<N>& message : batch->messages){batch_min = min(batch_min, message.g + message.h);}
+    atomic<int>& destination_min = workers[destination].frontier_min;
+    for(int seen = destination_min.load(memory_order_relaxed); batch_min < seen && !destination_min.compare_exchange_weak(seen, batch_min, memory_order_relaxed); ){}
+
+    atomic<hda_batch<N>*>& mailbox = workers[destination].mailbox;
+    batch->next = mailbox.load(memory_order_relaxed);
+    while(!mailbox.compare_exchange_weak(batch->next, batch, memory_order_release, memory_order_relaxed)){}
+
+} // end of hda_post function definition
+
+
+template<int N, typename Frontier>
+static void hda_run_worker(vector<hda_worker<N, Frontier>>& workers, int worker_id, const state<N>& goal_state, const goal_positions<N>& gps, int heuristic_choice, hda_shared& shared){ // start of hda_run_worker function definition
+    
+    /*
+       one HDA* thread: alternate between draining the mailbox and a round of expansions from the local frontier
+       a worker with nothing below U to expand flushes its outgoing batches and goes idle; it wakes up when a batch arrives
+          and the whole search ends once pending_work drops to 0
+       a round only expands nodes whose f is no higher than every other worker's frontier_min, so the workers advance through f together like one A*
+          instead of each running ahead on its own slice; a worker whose best node is above that bound yields until the others catch up
+       an idle worker polls its mailbox with backoff (a few yields, then sleeps that grow to HDA_MAX_IDLE_SLEEP_US) instead of spinning a core
+    */
+
+    hda_worker<N, Frontier>& worker = workers[worker_id];
+    int worker_count = static_cast<int>(workers.size());
+    bool active = true; // counted in pending_work from the start
+    int idle_checks = 0; // empty mailbox checks since the worker last had work
+
+    auto flush_outgoing = [&](){
+        for(int destination = 0; destination < worker_count; ++destination){
+            if(!worker.outgoing[destination].empty()){hda_post(workers, destination, worker.outgoing[destination], shared);}
+        }
+    };
+
+    while(!shared.out_of_ids.load(memory_order_relaxed)){ // start of the worker loop
+
+        // RECEIVE --- take every batch in the mailbox at once
+        hda_batch<N>* batch = worker.mailbox.exchange(nullptr, memory_order_acquire);
+        if(batch != nullptr && !active){shared.pending_work.fetch_add(1); active = true; idle_checks = 0;} // active again before the batches stop counting
+        while(batch != nullptr){
+            for(const hda_message<N>& message : batch->messages){hda_receive(worker, message, shared);}
+            hda_batch<N>* processed = batch;
+            batch = batch->next;
+            delete processed;
+            shared.pending_work.fetch_sub(1);
+        }
+        worker.frontier_min.store(worker.open.min_f(), memory_order_relaxed); // the received batches are in the frontier now
+
+        if(!active){
+            if(shared.pending_work.load() == 0){break;} // TERMINATION --- every worker idle and nothing in flight
+            if(idle_checks < HDA_IDLE_SPINS){this_thread::yield();}
+            else{this_thread::sleep_for(chrono::microseconds(min(HDA_MAX_IDLE_SLEEP_US, 8 << min(idle_checks - HDA_IDLE_SPINS, 6))));}
+            ++idle_checks;
+            continue;
+        }
+
+        // BOUND --- the lowest f any other worker holds or has on its way to it
+        int f_bound = INT_MAX;
+        for(int other = 0; other < worker_count; ++other){
+            if(other != worker_id){f_bound = min(f_bound, workers[other].frontier_min.load(memory_order_relaxed));}
+        }
+
+        // EXPAND --- one round from the local frontier, up to the bound
+        int each_expansion = 0;
+        for(; each_expansion < HDA_EXPANSIONS_PER_ROUND && !worker.open.empty() && worker.open.min_f() <= f_bound; ++each_expansion){ // start of each expansion
+
+            frontier_entry current_entry = worker.open.pop();
+            uint32_t current_local_id = current_entry.id;
+            Node<N>* current_node = &worker.arena[current_local_id];
+            if(current_entry.f != current_node->f){++worker.stats.stale_entries; continue;} // STALE ENTRY
+
+            if(current_entry.f >= shared.best_cost.load(memory_order_relaxed)){worker.open.clear(); break;} // nothing left here can beat the incumbent
+            
+            uint32_t current_id = (static_cast<uint32_t>(worker_id) << HDA_LOCAL_BITS) | current_local_id;
+            if(is_goal_state(current_node->s, goal_state)){ // GOAL TEST --- a new incumbent; keep going until nothing cheaper can exist
+                lock_guard<mutex> guard(shared.incumbent_lock);
+                if(current_node->g < shared.best_cost.load()){
+                    shared.best_cost.store(current_node->g);
+                    shared.best_id = current_id;
+                }
+                continue;
+            }
+
+            worker.states.close(*worker.states.find(current_node->s.packed));
+            ++worker.stats.nodes_expanded;
+
+            successor_list<N> children;
+            generate_children(current_node->s, current_node->move, children);
+            for(const auto& [move, next_state] : children){
+                hda_message<N> message;
+                message.s = next_state;
+                message.g = current_node->g + 1;
+                message.h = evaluate_heuristic_after_move(current_node->s, next_state, gps, heuristic_choice, current_node->h_manhattan, current_node->h_conflicts, message.h_manhattan, message.h_conflicts);
+                message.move = move;
+                message.parent = current_id;
+
+                int owner = hda_owner<N>(next_state.packed, worker_count);
+                if(owner == worker_id){hda_receive(worker, message, shared); current_node = &worker.arena[current_local_id];}
+                else{worker.outgoing[owner].push_back(message);}
+            }
+
+        } // end of each expansion
+
+        flush_outgoing();
+        worker.frontier_min.store(worker.open.min_f(), memory_order_relaxed);
+        if(worker.open.empty()){ // idle --- everything this worker produced is already posted
+            active = false;
+            shared.pending_work.fetch_sub(1);
+        }
+        else if(each_expansion == 0){this_thread::yield();} // everything here is above the bound --- let the workers below it run
+
+    } // end of the worker loop
+
+    // free whatever is left in the mailbox (only after giving up on ids --- a normal finish leaves it empty)
+    for(hda_batch<N>* batch = worker.mailbox.exchange(nullptr); batch != nullptr; ){
+        hda_batch<N>* processed = batch;
+        batch = batch->next;
+        delete processed;
+    }
+
+} // end of hda_run_worker function definition
+
+
+template<int N, typename Frontier>
+static bool hda_star_search(const state<N>& initial_state, const state<N>& goal_state, int heuristic_choice, int thread_count, search_context<N>& context, search_stats& stats, vector<char>& actions, vector<int>& fvalues){ // start of hda_star_search function definition
+    
+    /*
+       HDA* (Kishimoto, Fukunaga and Botea): A* on one puzzle spread over `thread_count` threads
+          every board has one owner (hda_owner), which alone keeps its node, its frontier entry and its explored flag --- duplicate detection stays exact
+          a worker that generates a child owned by someone else sends it over in a batch instead of touching the owner's structures
+       workers only ever synchronize through the mailboxes, pending_work, the incumbent and the published frontier minimums
+
+       node ids carry their worker (see HDA_LOCAL_BITS), so a parent link can point into another worker's arena and the path is walked across partitions
+       results are optimal like A*, but nodes_generated and the chosen path among equally short ones depend on thread timing
+       returns false if there is no solution
+    */
+
+    int worker_count = max(1, min(thread_count, HDA_MAX_WORKERS));
+    const goal_positions<N>& gps = context.goal_table(goal_state);
+
+    vector<hda_worker<N, Frontier>> workers(worker_count);
+    for(hda_worker<N, Frontier>& worker : workers){
+        worker.states.clear();
+        worker.outgoing.resize(worker_count);
+    }
+
+    hda_shared shared;
+    shared.pending_work.store(worker_count); // every worker starts active
+
+    // the root goes straight to its owner
+    hda_message<N> root;
+    root.s = initial_state;
+    root.g = 0;
+    root.h = evaluate_heuristic(initial_state.board, gps, heuristic_choice, root.h_manhattan, root.h_conflicts);
+    root.move = '\0';
+    root.parent = NO_NODE;
+    int root_owner = hda_owner<N>(initial_state.packed, worker_count);
+    hda_receive(workers[root_owner], root, shared);
+    workers[root_owner].frontier_min.store(root.g + root.h);
+
+    vector<thread> threads;
+    for(int worker_id = 1; worker_id < worker_count; ++worker_id){
+        threads.emplace_back(hda_run_worker<N, Frontier>, ref(workers), worker_id, cref(goal_state), cref(gps), heuristic_choice, ref(shared));
+    }
+    hda_run_worker(workers, 0, goal_state, gps, heuristic_choice, shared); // the calling thread is worker 0
+    for(thread& each_thread : threads){each_thread.join();}
+
+    size_t closed_size = 0, used_slots = 0, total_slots = 0;
+    for(const hda_worker<N, Frontier>& worker : workers){
+        stats.nodes_generated += worker.stats.nodes_generated;
+        stats.nodes_expanded += worker.stats.nodes_expanded;
+        stats.stale_entries += worker.stats.stale_entries;
+        stats.nodes_reopened += worker.stats.nodes_reopened;
+        closed_size += worker.states.closed_count;
+        used_slots += worker.states.used;
+        total_slots += worker.states.slots.size();
+    }
+    stats.closed_size = static_cast<long long>(closed_size); // the partitions together
+    stats.table_load_factor = total_slots == 0 ? 0.0f : static_cast<float>(used_slots) / total_slots;
+    if(shared.out_of_ids.load()){cerr << "HDA* ran out of node ids (" << HDA_LOCAL_MASK + 1 << " nodes per worker)." << endl; return false;}
+    if(shared.best_id == NO_NODE){return false;} // no solution found
+
+
+
+    // reconstruct the path across the partitions
+    for(uint32_t id = shared.best_id; ; ){
+        const Node<N>& current_node = workers[id >> HDA_LOCAL_BITS].arena[id & HDA_LOCAL_MASK];
+        fvalues.push_back(current_node.f);
+        if(current_node.parent == NO_NODE){break;}
+        actions.push_back(current_node.move);
+        id = current_node.parent;
+    }
+    reverse(actions.begin(), actions.end());
+    reverse(fvalues.begin(), fvalues.end());
+    return true;
+
+} // end of hda_star_search function definition
+
+
+
+
+
+                                                     /* =============================================== MEMORY-BOUNDED A* (--memory) =============================================== */
+
+/*
+   A* under a byte budget (--memory=<bytes>), for searches whose full Nodes would not fit in RAM
+
+   entries are cut down to what A* needs: the packed board, g and the move that reached it
+      --- a table slot is 12 bytes for 3x3/4x4 and a frontier record 16, against a ~110-byte Node plus its slot and frontier entry;
+      h is recomputed when a board is scored (the batched kernel on 3x3/4x4), a parent is found by undoing the move,
+      and the f values of the solution are replayed at the end
+   the frontier is layered by f (then g, LIFO, like bucket_frontier); when table + frontier outgrow the budget, layers from the highest f
+      down are sorted by board, de-duplicated and spilled to one file per layer under --spill-dir (external-memory A* style),
+      and their boards leave the table; a layer is streamed back once the search reaches its f, and records whose board was reached
+      as cheaply in the meantime are dropped then (delayed duplicate detection)
+   explored boards always stay in the table (they carry the solution path), so the budget caps the explored set:
+      when the table can neither grow nor take another board the search stops and says so, instead of being OOM-killed
+*/
+
+template<int N>
+struct compact_table{ // start of compact_table struct definition
+
+    /*
+       packed board --> packed info (g, reaching move, explored bit), open addressing with linear probing like state_table,
+          but keys and infos sit in two arrays (12 bytes a slot for 3x3/4x4) and entries can be erased (backward-shift deletion, no tombstones)
+       key 0 marks an empty slot --- no board packs to 0
+
+       the arrays are anonymous mappings: growing is an mremap (new slots read as empty) and a rehash in place, so the old and the new table
+          are never alive side by side and the table can use the whole budget; the capacity need not be a power of two
+    */
+
+    static const uint32_t G_MASK = 0xFFFF;
+    static const int MOVE_SHIFT = 16;            // 3 bits: 0 for the root, else 1 + index of the move in "LRUD"
+    static const uint32_t SETTLED_BIT = 1u << 29; // only set while grow() rehashes
+    static const uint32_t EXPLORED_BIT = 1u << 30; // expanded at least once --- kept through re-opening, so the board is never spilled (closed boards may lead back through it)
+    static const uint32_t CLOSED_BIT = 1u << 31;
+
+    board_key<N>* keys = nullptr;
+    uint32_t* infos = nullptr;
+    size_t capacity = 0;
+    size_t keys_mapped = 0, infos_mapped = 0; // bytes of each mapping --- one can be ahead of `capacity` if growing the other failed
+    size_t used = 0;
+
+    compact_table() = default;
+    compact_table(const compact_table&) = delete;
+    compact_table& operator=(const compact_table&) = delete;
+    ~compact_table(){
+        if(keys != nullptr){munmap(keys, keys_mapped);}
+        if(infos != nullptr){munmap(infos, infos_mapped);}
+    }
+
+    static uint8_t move_code(char move){
+        const char* found = strchr("LRUD", move);
+        return (move == '\0' || found == nullptr) ? 0 : static_cast<uint8_t>(found - "LRUD" + 1);
+    }
+    static char move_of_code(uint8_t code){return code == 0 ? '\0' : "LRUD"[code - 1];}
+
+    static uint32_t pack(int g, uint8_t code){return static_cast<uint32_t>(g) | (uint32_t(code) << MOVE_SHIFT);} // open
+    static int g_of(uint32_t info){return static_cast<int>(info & G_MASK);}
+    static uint8_t code_of(uint32_t info){return static_cast<uint8_t>((info >> MOVE_SHIFT) & 7);}
+    static bool is_closed(uint32_t info){return (info & CLOSED_BIT) != 0;}
+    static bool was_explored(uint32_t info){return (info & EXPLORED_BIT) != 0;}
+    static void reopen(uint32_t& info, int g, uint8_t code){info = pack(g, code) | (info & EXPLORED_BIT);} // a cheaper path: open again, still marked explored
+
+    static constexpr size_t SLOT_BYTES = sizeof(board_key<N>) + sizeof(uint32_t);
+    size_t bytes() const {return capacity * SLOT_BYTES;}
+
+    size_t home_slot(board_key<N> key) const { // state_table's Fibonacci hashing, scaled onto any capacity by a multiply-high
+        uint64_t folded = static_cast<uint64_t>(key) ^ static_cast<uint64_t>(key >> (sizeof(key) * 8 / 2) >> (sizeof(key) * 8 / 2));
+        return static_cast<size_t>((static_cast<unsigned __int128>(folded * 0x9E3779B97F4A7C15ull) * capacity) >> 64);
+    }
+    size_t next_slot(size_t index) const {return index + 1 == capacity ? 0 : index + 1;}
+    size_t distance(size_t from, size_t to) const {return to >= from ? to - from : to + capacity - from;} // probes from `from` forward to `to`
+
+    uint32_t* find(board_key<N> key){
+        for(size_t index = home_slot(key); keys[index] != 0; index = next_slot(index)){
+            if(keys[index] == key){return &infos[index];}
+        }
+        return nullptr;
+    }
+
+    void insert(board_key<N> key, uint32_t info){ // `key` must not be in the table yet, and the caller has made room
+        size_t index = home_slot(key);
+        while(keys[index] != 0){index = next_slot(index);}
+        keys[index] = key;
+        infos[index] = info;
+        ++used;
+    }
+
+    void erase(board_key<N> key){
+        size_t hole = home_slot(key);
+        while(keys[hole] != key){
+            if(keys[hole] == 0){return;}
+            hole = next_slot(hole);
+        }
+        // shift back every later entry of the run that may sit in the hole without ending up before its home slot
+        for(size_t next = next_slot(hole); keys[next] != 0; next = next_slot(next)){
+            if(distance(home_slot(keys[next]), next) >= distance(hole, next)){
+                keys[hole] = keys[next];
+                infos[hole] = infos[next];
+                hole = next;
+            }
+        }
+        keys[hole] = 0;
+        --used;
+    }
+
+    template<typename T>
+    static bool extend_mapping(T*& mapping, size_t& mapped, size_t wanted){
+        if(wanted <= mapped){return true;}
+        void* grown = (mapping == nullptr) ? mmap(nullptr, wanted, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+                                           : mremap(mapping, mapped, wanted, MREMAP_MAYMOVE);
+        if(grown == MAP_FAILED){return false;}
+        mapping = static_cast<T*>(grown);
+        mapped = wanted;
+        return true;
+    }
+
+    bool grow(size_t new_capacity){ // returns false (table unchanged) if the system refuses the memory
+
+        if(!extend_mapping(keys, keys_mapped, new_capacity * sizeof(board_key<N>)) || !extend_mapping(infos, infos_mapped, new_capacity * sizeof(uint32_t))){return false;}
+        size_t old_capacity = capacity;
+        capacity = new_capacity;
+
+        // every entry still sits in [0, old_capacity); take each unsettled one out and probe from its new home for a slot that is empty
+           // or holds another unsettled entry, which is carried on in turn --- settled entries never move again, so each finds every
+           // slot between its home and itself occupied, which is all linear probing needs
+        for(size_t index = 0; index < old_capacity; ++index){
+            if(keys[index] == 0 || (infos[index] & SETTLED_BIT)){continue;}
+            board_key<N> carried_key = keys[index];
+            uint32_t carried_info = infos[index];
+            keys[index] = 0;
+            while(true){
+                size_t slot = home_slot(carried_key);
+                while(keys[slot] != 0 && (infos[slot] & SETTLED_BIT)){slot = next_slot(slot);}
+                board_key<N> evicted_key = keys[slot];
+                uint32_t evicted_info = infos[slot];
+                keys[slot] = carried_key;
+                infos[slot] = carried_info | SETTLED_BIT;
+                if(evicted_key == 0){break;}
+                carried_key = evicted_key;
+                carried_info = evicted_info;
+            }
+        }
+        for(size_t index = 0; index < capacity; ++index){infos[index] &= ~SETTLED_BIT;}
+        return true;
+
+    }
+
+}; // end of compact_table struct definition
+
+
+template<int N>
+static void score_children(const board_key<N>* keys, const int* blank_cells, int count, const goal_positions<N>& gps, int heuristic_choice, int* h_values){ // start of score_children function definition
+    
+    /* h of packed boards: the batched kernel where there is one (3x3/4x4, h1/h2), otherwise each board unpacked and evaluated in full */
+
+    if constexpr(board_traits<N>::TILE_BITS == 4){
+        if(heuristic_choice != 3){score_boards<N>(keys, blank_cells, count, gps, heuristic_choice == 2, h_values); return;}
+    }
+
+    const board_key<N> tile_mask = (board_key<N>(1) << board_traits<N>::TILE_BITS) - 1;
+    for(int each_board = 0; each_board < count; ++each_board){
+        board_grid<N> board;
+        for(int cell = 0; cell < N * N; ++cell){board[cell / N][cell % N] = static_cast<int>((keys[each_board] >> (cell * board_traits<N>::TILE_BITS)) & tile_mask);}
+        int manhattan, conflicts;
+        h_values[each_board] = evaluate_heuristic(board, gps, heuristic_choice, manhattan, conflicts);
+    }
+
+} // end of score_children function definition
+
+
+template<int N>
+struct memory_bounded_search{ // start of memory_bounded_search struct definition
+
+    /* one --memory search: the compact table, the f-layered frontier with its spill files, and the budget they share */
+
+    struct record{ // one frontier entry, in RAM or in a spill file
+        board_key<N> key;
+        uint16_t g;
+        uint8_t move_code; // compact_table::move_code of the move that reached the board
+        uint8_t blank;     // cell of the blank
+    };
+
+    struct layer{ // every frontier record with one f value
+        vector<vector<record>> stacks; // [g] --> LIFO stack
+        int top_g = -1;                // highest g that may still hold records
+        size_t size = 0;               // records in RAM
+        int file = -1;                 // spill file, opened (and unlinked) the first time the layer is spilled
+        off_t written = 0;             // bytes appended to the file
+        off_t read = 0;                // bytes streamed back in
+    };
+
+    static constexpr size_t RELOAD_RECORDS = 1 << 15; // records streamed back per read --- the layer being expanded keeps at least this many in RAM when spilled
+
+    compact_table<N> table;
+    vector<layer> layers;
+    int lowest_f = 0;        // no layer below this holds records (in RAM or on disk)
+    size_t ram_records = 0;
+    size_t frontier_capacity = 0; // records the frontier stacks have room for --- what they actually hold on to
+    size_t closed_count = 0; // explored boards in the table
+
+    size_t budget = 0;
+    string spill_dir;
+    bool exhausted = false;  // the explored set outgrew the budget
+    bool spill_failed = false;
+    int spill_errno = 0;     // errno of the failed spill call, taken where it failed
+    bool path_lost = false;  // reconstruct met a board missing from the table
+    search_stats* stats = nullptr;
+
+    memory_bounded_search() = default;
+    memory_bounded_search(const memory_bounded_search&) = delete;
+    memory_bounded_search& operator=(const memory_bounded_search&) = delete;
+    ~memory_bounded_search(){
+        for(layer& each_layer : layers){if(each_layer.file >= 0){close(each_layer.file);}}
+    }
+
+    size_t frontier_bytes() const {return frontier_capacity * sizeof(record);}
+    size_t used_bytes() const {return table.bytes() + frontier_bytes();}
+
+    size_t table_limit() const { // slots the table may grow to: the budget less room for the working set of the layer being expanded
+        size_t reserved = 2 * RELOAD_RECORDS * sizeof(record);
+        return budget > reserved ? (budget - reserved) / compact_table<N>::SLOT_BYTES : 0;
+    }
+
+    void push(int f, const record& entry){
+        if(f >= static_cast<int>(layers.size())){layers.resize(f + 1);}
+        layer& target = layers[f];
+        if(entry.g >= static_cast<int>(target.stacks.size())){target.stacks.resize(entry.g + 1);}
+        vector<record>& stack = target.stacks[entry.g];
+        size_t old_capacity = stack.capacity();
+        stack.push_back(entry);
+        frontier_capacity += stack.capacity() - old_capacity;
+        target.top_g = max(target.top_g, static_cast<int>(entry.g));
+        ++target.size;
+        ++ram_records;
+        lowest_f = min(lowest_f, f); // h2 is not always consistent, so a re-opened board can land below the current layer
+    }
+
+    bool reserve_slot(){ // room in the table for one more board --- grows it while the budget allows, then makes room by spilling open boards
+        if(4 * (table.used + 1) <= 3 * table.capacity){return true;}
+        size_t grown = min(2 * table.capacity, table_limit());
+        if(grown >= table.capacity + table.capacity / 8){ // a step worth a rehash (grow() works in place, so only the grown table counts)
+            size_t grown_bytes = grown * compact_table<N>::SLOT_BYTES;
+            if(grown_bytes + frontier_bytes() > budget){spill(budget - grown_bytes);} // the frontier makes way first
+            if(spill_failed){return false;}
+            if(table.grow(grown)){return true;}
+        }
+        if(20 * (table.used + 1) <= 19 * table.capacity){return true;}
+        spill(0); // the table is as big as it gets --- every open board that can go to disk leaves it
+        if(!spill_failed && 5 * (table.used + 1) <= 4 * table.capacity){return true;} // enough room freed that the next spill is a while off
+        exhausted = true;
+        return false;
+    }
+
+    void fail_spill(int error){spill_failed = true; spill_errno = error;}
+
+    bool write_all(int file, const char* data, size_t length){
+        while(length > 0){
+            ssize_t written = write(file, data, length);
+            if(written < 0 && errno == EINTR){continue;}
+            if(written <= 0){fail_spill(written < 0 ? errno : EIO); return false;}
+            data += written;
+            length -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    void spill_layer(int f, size_t keep){ // moves the layer's records (all but `keep`, deepest last) to its file
+
+        layer& source = layers[f];
+        vector<record> outgoing;
+        size_t outgoing_count = 0; // sized up front, so the copy never holds more than the records themselves
+        for(int g = 0; g <= source.top_g; ++g){outgoing_count += source.stacks[g].size();}
+        outgoing.reserve(outgoing_count > keep ? outgoing_count - keep : 0);
+        for(int g = 0; g <= source.top_g && source.size > keep; ++g){
+            vector<record>& stack = source.stacks[g];
+            if(stack.empty() || source.size - stack.size() < keep){ // stays in RAM, but gives back what popping left unused
+                if(stack.capacity() > 2 * stack.size()){frontier_capacity -= stack.capacity(); stack.shrink_to_fit(); frontier_capacity += stack.capacity();}
+                continue;
+            }
+            for(const record& entry : stack){
+                uint32_t* info = table.find(entry.key);
+                if(info != nullptr && (compact_table<N>::is_closed(*info) || compact_table<N>::g_of(*info) != entry.g)){++stats->stale_entries; continue;} // superseded
+                if(info != nullptr && !compact_table<N>::was_explored(*info)){table.erase(entry.key);} // the board now lives on disk only --- a re-opened one stays, it is on other boards' paths
+                outgoing.push_back(entry);
+            }
+            source.size -= stack.size();
+            ram_records -= stack.size();
+            frontier_capacity -= stack.capacity();
+            vector<record>().swap(stack); // hand the memory back, not just the size
+        }
+        if(outgoing.empty()){return;}
+
+        // sorted by board, cheapest first, one record per board --- the file holds sorted runs of distinct boards
+        sort(outgoing.begin(), outgoing.end(), [](const record& a, const record& b){return a.key < b.key || (a.key == b.key && a.g < b.g);});
+        outgoing.erase(unique(outgoing.begin(), outgoing.end(), [](const record& a, const record& b){return a.key == b.key;}), outgoing.end());
+
+        if(source.file < 0){
+            string path = spill_dir + "/eight-puzzle-spill-XXXXXX";
+            source.file = mkstemp(&path[0]);
+            if(source.file < 0){fail_spill(errno); return;}
+            unlink(path.c_str()); // the file lives until it is closed, and never outlives the process
+        }
+        if(lseek(source.file, source.written, SEEK_SET) < 0){fail_spill(errno); return;}
+        if(!write_all(source.file, reinterpret_cast<const char*>(outgoing.data()), outgoing.size() * sizeof(record))){return;}
+        source.written += static_cast<off_t>(outgoing.size() * sizeof(record));
+        stats->frontier_spilled += static_cast<long long>(outgoing.size());
+
+    }
+
+    void spill(size_t target_bytes){ // spills layers from the highest f down until the in-RAM frontier fits in target_bytes
+
+        int current = lowest_f; // the layer being expanded keeps a working set
+        while(current < static_cast<int>(layers.size()) && layers[current].size == 0 && layers[current].read == layers[current].written){++current;}
+
+        size_t before = frontier_bytes();
+        for(int f = static_cast<int>(layers.size()) - 1; f >= current && frontier_bytes() > target_bytes && !spill_failed; --f){
+            if(layers[f].size > 0){spill_layer(f, f == current ? RELOAD_RECORDS : 0);}
+        }
+        if(frontier_bytes() < before){malloc_trim(0);} // the freed stacks are scattered over the heap --- hand their pages back so RSS follows the budget
+
+    }
+
+    void reload(int f){ // streams the next block of the layer's spilled records back into the table and RAM
+
+        size_t count = min(RELOAD_RECORDS, static_cast<size_t>(layers[f].written - layers[f].read) / sizeof(record));
+        vector<record> incoming(count);
+        size_t length = count * sizeof(record), received = 0;
+        while(received < length){
+            ssize_t got = pread(layers[f].file, reinterpret_cast<char*>(incoming.data()) + received, length - received, layers[f].read + static_cast<off_t>(received));
+            if(got < 0 && errno == EINTR){continue;}
+            if(got <= 0){fail_spill(got < 0 ? errno : EIO); return;}
+            received += static_cast<size_t>(got);
+        }
+        layers[f].read += static_cast<off_t>(length);
+        if(layers[f].read == layers[f].written){layers[f].read = layers[f].written = 0;} // all back --- the file's space is reused by the next spill
+
+        for(const record& entry : incoming){
+            uint32_t* info = table.find(entry.key);
+            if(info != nullptr){
+                int known_g = compact_table<N>::g_of(*info);
+                bool closed = compact_table<N>::is_closed(*info);
+                if(known_g < entry.g || (known_g == entry.g && closed)){++stats->stale_entries; continue;} // reached as cheaply meanwhile
+                if(known_g > entry.g){
+                    if(closed){++stats->nodes_reopened; --closed_count;}
+                    compact_table<N>::reopen(*info, entry.g, entry.move_code);
+                }
+                // known_g == entry.g and open: a re-opened board that stayed in the table while its record was on disk
+            }
+            else{
+                if(!reserve_slot()){return;}
+                table.insert(entry.key, compact_table<N>::pack(entry.g, entry.move_code));
+            }
+            push(f, entry);
+        }
+
+    }
+
+    bool pop(record& entry){ // the next record (lowest f, then highest g), streaming spilled layers back in as they come up
+
+        while(lowest_f < static_cast<int>(layers.size()) && !exhausted && !spill_failed){
+            layer& current = layers[lowest_f];
+            if(current.size == 0){
+                if(current.read < current.written){reload(lowest_f);}
+                else{ // done with this layer for now --- give back what its stacks still hold on to
+                    for(vector<record>& stack : current.stacks){frontier_capacity -= stack.capacity(); vector<record>().swap(stack);}
+                    current.top_g = -1;
+                    ++lowest_f;
+                }
+                continue;
+            }
+            while(current.stacks[current.top_g].empty()){--current.top_g;}
+            entry = current.stacks[current.top_g].back();
+            current.stacks[current.top_g].pop_back();
+            --current.size;
+            --ram_records;
+            return true;
+        }
+        return false;
+
+    }
+
+    bool reconstruct(board_key<N> key, int blank_cell, vector<char>& actions){ // walks back from `key` by undoing each board's reaching move
+
+        /* every board on the path was expanded, and explored boards are never spilled --- a missing one would be a bug, reported rather than followed */
+
+        while(true){
+            const uint32_t* info = table.find(key);
+            if(info == nullptr){path_lost = true; return false;}
+            char move = compact_table<N>::move_of_code(compact_table<N>::code_of(*info));
+            if(move == '\0'){break;} // the root
+            actions.push_back(move);
+
+            char undo_move = inverse_move(move);
+            const move_table_row& legal_moves = MOVE_TABLE<N>[blank_cell];
+            for(int each_option = 0; each_option < legal_moves.count; ++each_option){
+                if(legal_moves.options[each_option].action != undo_move){continue;}
+                key = slide_key<N>(key, blank_cell, legal_moves.options[each_option].target_cell);
+                blank_cell = legal_moves.options[each_option].target_cell;
+                break;
+            }
+        }
+        reverse(actions.begin(), actions.end());
+        return true;
+
+    }
+
+    bool run(const state<N>& initial_state, const state<N>& goal_state, const goal_positions<N>& gps, int heuristic_choice, vector<char>& actions){ // start of the memory-bounded A* loop
+
+        if(!table.grow(min(size_t(1) << 16, table_limit()))){exhausted = true; return false;}
+        layers.clear();
+        lowest_f = INT_MAX;
+        ram_records = 0;
+        frontier_capacity = 0;
+
+        int root_blank = initial_state.blank_s_row * N + initial_state.blank_s_col;
+        int root_h;
+        score_children<N>(&initial_state.packed, &root_blank, 1, gps, heuristic_choice, &root_h);
+        table.insert(initial_state.packed, compact_table<N>::pack(0, 0));
+        push(root_h, {initial_state.packed, 0, 0, static_cast<uint8_t>(root_blank)});
+        ++stats->nodes_generated;
+
+        record current;
+        while(pop(current)){
+
+            uint32_t* info = table.find(current.key);
+            if(info == nullptr || compact_table<N>::is_closed(*info) || compact_table<N>::g_of(*info) != current.g){++stats->stale_entries; continue;} // superseded
+
+            if(current.key == goal_state.packed){return reconstruct(current.key, current.blank, actions);} // GOAL TEST
+
+            *info |= compact_table<N>::CLOSED_BIT | compact_table<N>::EXPLORED_BIT;
+            ++closed_count;
+            ++stats->nodes_expanded;
+
+            // children straight from the packed board, scored together
+            board_key<N> child_keys[4];
+            int child_blanks[4], child_h[4];
+            char child_actions[4];
+            int child_count = 0;
+
+            char undo_move = inverse_move(compact_table<N>::move_of_code(current.move_code));
+            const move_table_row& legal_moves = MOVE_TABLE<N>[current.blank];
+            for(int each_option = 0; each_option < legal_moves.count; ++each_option){
+                const move_option& option = legal_moves.options[each_option];
+                if(option.action == undo_move){continue;} // going straight back to the parent
+                child_keys[child_count] = slide_key<N>(current.key, current.blank, option.target_cell);
+                child_blanks[child_count] = option.target_cell;
+                child_actions[child_count] = option.action;
+                ++child_count;
+            }
+            score_children<N>(child_keys, child_blanks, child_count, gps, heuristic_choice, child_h);
+
+            for(int each_child = 0; each_child < child_count; ++each_child){
+
+                int child_g = current.g + 1;
+                uint8_t code = compact_table<N>::move_code(child_actions[each_child]);
+                record child = {child_keys[each_child], static_cast<uint16_t>(child_g), code, static_cast<uint8_t>(child_blanks[each_child])};
+
+                uint32_t* reached = table.find(child.key);
+                if(reached != nullptr){
+                    if(child_g >= compact_table<N>::g_of(*reached)){continue;} // the known path is at least as cheap
+                    if(compact_table<N>::is_closed(*reached)){++stats->nodes_reopened; --closed_count;}
+                    compact_table<N>::reopen(*reached, child_g, code); // re-opened, or a cheaper frontier entry (the old record goes stale)
+                    push(child_g + child_h[each_child], child);
+                    continue;
+                }
+
+                if(!reserve_slot()){return false;}
+                table.insert(child.key, compact_table<N>::pack(child_g, code));
+                push(child_g + child_h[each_child], child);
+                ++stats->nodes_generated;
+
+            }
+
+            if(used_bytes() > budget){spill(budget > table.bytes() ? (budget - table.bytes()) / 2 : 0);} // leave headroom so spills come in batches
+            if(spill_failed){return false;}
+
+        }
+        return false;
+
+    } // end of the memory-bounded A* loop
+
+}; // end of memory_bounded_search struct definition
+
+
+template<int N>
+static bool memory_bounded_a_star(const state<N>& initial_state, const state<N>& goal_state, int heuristic_choice, size_t memory_budget, const string& spill_dir, search_context<N>& context, search_stats& stats, vector<char>& actions, vector<int>& fvalues){ // start of memory_bounded_a_star function definition
+    
+    /*
+       A* within `memory_budget` bytes (table + in-RAM frontier; allocator slack and the process itself come on top), spilling to `spill_dir`
+       fills `actions`/`fvalues` like reconstruct_solution does; returns false with stats.memory_exhausted set when the explored set outgrew the budget,
+          or with stats.spill_failed set when a spill file failed
+    */
+
+    const goal_positions<N>& gps = context.goal_table(goal_state);
+
+    memory_bounded_search<N> search;
+    search.budget = memory_budget;
+    search.spill_dir = spill_dir;
+    search.stats = &stats;
+
+    bool found = search.run(initial_state, goal_state, gps, heuristic_choice, actions);
+    stats.closed_size = static_cast<long long>(search.closed_count);
+    stats.table_load_factor = search.table.capacity == 0 ? 0.0f : static_cast<float>(search.table.used) / search.table.capacity;
+    if(search.spill_failed){cerr << "Writing or reading a spill file under " << spill_dir << " failed: " << strerror(search.spill_errno) << endl;}
+    if(search.path_lost){cerr << "The memory-bounded search lost a board of its solution path." << endl;}
+    stats.memory_exhausted = search.exhausted;
+    stats.spill_failed = search.spill_failed;
+    if(!found){return false;}
+
+    replay_fvalues(initial_state, actions, gps, heuristic_choice, fvalues);
+    return true;
+
+} // end of memory_bounded_a_star function definition
+
+
+
+
+                                                     /* =============================================== PATTERN DATABASE (h3) =============================================== */
+
+
+static bool build_pattern_database(const string& filename){ // start of build_pattern_database function definition
+    
+    /*
+       builds the exact distance table behind h3 and writes it to `filename`
+
+       for each of the 9 goal blank cells we breadth-first search the whole state space outward from the canonical goal for that cell
+          (tiles 1..8 in reading order around the blank) and store each state's depth in its pdb_index slot --- 1 byte per state
+
+       file layout: PDB_MAGIC, then 9 tables of 9!/2 bytes (one per goal blank cell)
+       this only has to run once; the solver processes then share the file read-only through mmap (see load_pattern_database)
+    */
+
+    constexpr int N = 3; // the database covers the 8-puzzle only
+
+    vector<uint8_t> table(PDB_CELLS * PDB_ENTRIES_PER_GOAL, UINT8_MAX); // UINT8_MAX marks "not reached yet"
+    vector<state<N>> bfs_queue;
+    successor_list<N> children;
+    bfs_queue.reserve(PDB_ENTRIES_PER_GOAL);
+
+    for(int goal_blank_cell = 0; goal_blank_cell < PDB_CELLS; ++goal_blank_cell){ // start of building one table
+
+        // lay out the canonical goal for this blank cell
+        state<N> canonical_goal{};
+        int next_tile = 1;
+        for(int each_cell = 0; each_cell < PDB_CELLS; ++each_cell){
+            canonical_goal.board[each_cell / N][each_cell % N] = (each_cell == goal_blank_cell) ? 0 : next_tile++;
+        }
+        canonical_goal.blank_s_row = goal_blank_cell / N;
+        canonical_goal.blank_s_col = goal_blank_cell % N;
+        canonical_goal.packed = pack_board<N>(canonical_goal.board);
+
+        goal_positions<N> gps = record_goal_positions<N>(canonical_goal.board);
+
+
+        // breadth-first search outward from the goal --- the queue is consumed in order so each state's depth is final when it is first reached
+        bfs_queue.clear();
+        bfs_queue.push_back(canonical_goal);
+        table[pdb_index(canonical_goal.board, gps)] = 0;
+
+        for(size_t head = 0; head < bfs_queue.size(); ++head){
+
+            const state<N> current_state = bfs_queue[head]; // copy --- push_back below may reallocate
+            uint8_t child_depth = table[pdb_index(current_state.board, gps)] + 1;
+
+            generate_children(current_state, '\0', children);
+            for(const auto& [move, next_state] : children){
+                uint8_t& slot = table[pdb_index(next_state.board, gps)];
+                if(slot != UINT8_MAX){continue;} // already reached at a smaller or equal depth
+                slot = child_depth;
+                bfs_queue.push_back(next_state);
+            }
+        }
+
+        if(bfs_queue.size() != static_cast<size_t>(PDB_ENTRIES_PER_GOAL)){ // every slot must be reachable, otherwise pdb_index is broken
+            cerr << "Pattern database build reached " << bfs_queue.size() << " states instead of " << PDB_ENTRIES_PER_GOAL << "." << endl;
+            return false;
+        }
+
+    } // end of building one table
+
+
+    ofstream output_file(filename, ios::binary);
+    if(!output_file){cerr << "Failed to open the pattern database file for writing." << endl; return false;}
+    output_file.write(PDB_MAGIC, sizeof(PDB_MAGIC));
+    output_file.write(reinterpret_cast<const char*>(table.data()), table.size());
+    if(!output_file){cerr << "Failed to write the pattern database file." << endl; return false;}
+
+    return true;
+
+} // end of build_pattern_database function definition
+
+
+
+static bool load_pattern_database(const string& filename){ // start of load_pattern_database function definition
+    
+    /*
+       memory-maps the table written by build_pattern_database and points `pdb_table` at it
+       the mapping is read-only and shared, so every solver process on the host uses the same page-cache copy
+       it stays mapped for the life of the process
+    */
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0){cerr << "Failed to open the pattern database file " << filename << ". Build it with --build-pdb." << endl; return false;}
+
+    struct stat file_info;
+    const size_t expected_size = sizeof(PDB_MAGIC) + static_cast<size_t>(PDB_CELLS) * PDB_ENTRIES_PER_GOAL;
+    if(fstat(fd, &file_info) != 0 || static_cast<size_t>(file_info.st_size) != expected_size){
+        cerr << "The pattern database file " << filename << " has the wrong size." << endl;
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, expected_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the file referenced
+    if(mapping == MAP_FAILED){cerr << "Failed to memory-map the pattern database file." << endl; return false;}
+
+    if(memcmp(mapping, PDB_MAGIC, sizeof(PDB_MAGIC)) != 0){
+        cerr << "The file " << filename << " is not a pattern database." << endl;
+        munmap(mapping, expected_size);
+        return false;
+    }
+
+    pdb_table = static_cast<const uint8_t*>(mapping) + sizeof(PDB_MAGIC);
+    return true;
+
+} // end of load_pattern_database function definition
+
+
+template<int N>
+static bool oracle_search(const state<N>& initial_state, const state<N>& goal_state, int heuristic_choice, search_context<N>& context, search_stats& stats, vector<char>& actions, vector<int>& fvalues){ // start of oracle_search function definition
+    
+    /*
+       answers a query straight from the pattern database, which holds the exact distance of every state to the goal (after relabeling, see pdb_index)
+          from the initial state we repeatedly step to a child exactly one move closer --- one always exists --- until the distance hits 0
+       that is depth steps of at most 4 table lookups each: an optimal path with no frontier, no hash tables and no node allocation
+
+       `fvalues` use the heuristic the user chose (g + h), like the other search engines; nodes_generated counts the root and every child looked up
+       returns false if the start is not in the goal's parity class (the caller's is_solvable check normally rules that out)
+    */
+
+    if constexpr(N * N != PDB_CELLS){return false;} // never reached --- the oracle is refused for other board sizes before any search runs
+    else{
+
+        const goal_positions<N>& gps = context.goal_table(goal_state);
+
+        state<N> current_state = initial_state;
+        int distance = pdb_table[pdb_index(current_state.board, gps)];
+        if(distance == UINT8_MAX){return false;}
+        ++stats.nodes_generated; // the root
+
+        int manhattan, conflicts;
+        fvalues.push_back(evaluate_heuristic(current_state.board, gps, heuristic_choice, manhattan, conflicts));
+
+        successor_list<N> children;
+        char last_move = '\0';
+        for(int g = 1; distance > 0; ++g, --distance){ // start of each step
+
+            generate_children(current_state, last_move, children);
+            ++stats.nodes_expanded;
+            stats.nodes_generated += children.count;
+
+            bool stepped = false;
+            for(const auto& [move, next_state] : children){
+                if(pdb_table[pdb_index(next_state.board, gps)] != distance - 1){continue;} // not on an optimal path
+
+                current_state = next_state;
+                last_move = move;
+                actions.push_back(move);
+                fvalues.push_back(g + evaluate_heuristic(current_state.board, gps, heuristic_choice, manhattan, conflicts));
+                stepped = true;
+                break;
+            }
+            if(!stepped){cerr << "The pattern database is inconsistent --- rebuild it with --build-pdb." << endl; return false;}
+
+        } // end of each step
+
+        return true;
+    }
+
+} // end of oracle_search function definition
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/* =============================================== MAIN =============================================== */
+
+
+struct output_writer{ // start of output_writer struct definition
+
+    /*
+       result text is formatted straight into one large buffer and handed to write(2) a full buffer at a time,
+          instead of going through cout a tile at a time
+       anything else printed to the same descriptor (cout, e.g. --trace) must only be printed after a flush()
+       with no descriptor (-1) the buffer just grows and text() hands back everything put --- the daemon builds its replies this way
+    */
+
+    static constexpr size_t CAPACITY = 1 << 20;
+
+    int fd;
+    vector<char> buffer;
+    size_t used = 0;
+
+    explicit output_writer(int descriptor, size_t capacity = CAPACITY) : fd(descriptor), buffer(capacity) {}
+    output_writer(const output_writer&) = delete;
+    output_writer& operator=(const output_writer&) = delete;
+    ~output_writer(){flush();}
+
+    void make_room(size_t bytes){
+        if(buffer.size() - used >= bytes){return;}
+        if(fd < 0){buffer.resize(max(2 * buffer.size(), used + bytes)); return;}
+        flush();
+    }
+
+    void put(char c){
+        make_room(1);
+        buffer[used++] = c;
+    }
+
+    void put(const char* text){
+        for(; *text != '\0'; ++text){put(*text);}
+    }
+
+    void put(long long value){
+        make_room(24);
+        char digits[24];
+        int count = 0;
+        unsigned long long magnitude = (value < 0) ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+        do{digits[count++] = static_cast<char>('0' + magnitude % 10); magnitude /= 10;}while(magnitude != 0);
+        if(value < 0){buffer[used++] = '-';}
+        while(count > 0){buffer[used++] = digits[--count];}
+    }
+
+    void put(int value){put(static_cast<long long>(value));}
+
+    string text() const {return string(buffer.data(), used);}
+
+    void flush(){
+        if(fd < 0){return;}
+        size_t written = 0;
+        while(written < used){
+            ssize_t result = write(fd, buffer.data() + written, used - written);
+            if(result < 0 && errno == EINTR){continue;}
+            if(result <= 0){break;} // the reader went away --- nothing useful left to do with the output
+            written += static_cast<size_t>(result);
+        }
+        used = 0;
+    }
+
+}; // end of output_writer struct definition
+
+
+template<int N>
+static void print_board(output_writer& output, const board_grid<N>& board){ // start of print_board function definition
+    
+    /* 
+       print the board in the required format
+       boards with two-digit tiles (4x4 and up) separate the tiles with a space, otherwise a row like 1 11 2 would be ambiguous
+    */
+
+    for(int each_row = 0; each_row < N; ++each_row){
+        for(int each_col = 0; each_col < N; ++each_col){
+            if(N * N > 10 && each_col > 0){output.put(' ');}
+            output.put(board[each_row][each_col]);
+        }
+        output.put('\n');
+    }
+} // end of print_board function definition
+
+template<int N>
+static void reconstruct_solution(const node_arena<N>& arena, uint32_t final_id, vector<char>& actions, vector<int>& fvalues){ // start of reconstruct_solution function definition
+     
+    /* reconstruct the solution path by manipulating the `actions` and `fvalues` collections */
+
+    const Node<N>* current_node = &arena[final_id];
+
+    while(current_node->parent != NO_NODE){
+        actions.push_back(current_node->move); // reminder: `move` is the action that led to the current node from its parent node
+        fvalues.push_back(current_node->f);   // put the f values of nodes on the solution path into the collection
+        current_node = &arena[current_node->parent]; // simulate going up the tree to the parent node
+    }
+    // when current_node is the root node, we don't want to put the action into the collection but we do want to put the f value into the collection
+    fvalues.push_back(current_node->f);   // put the f value of the root node into the collection
+
+
+
+    // reaching here, our solution path collections are in reverse order
+
+    reverse(actions.begin(), actions.end()); // correct order is root --> n1 --> n2 --> ... --> final_node
+    reverse(fvalues.begin(), fvalues.end());
+
+} // end of reconstruct_solution function definition
+
+
+
+struct board_reader{ // start of board_reader struct definition
+
+    /*
+       hands out the numbers of an input one at a time through a hand-rolled digit scanner (no iostream formatting per tile)
+       a regular file is memory-mapped whole; anything that cannot be mapped (stdin, a pipe) is read into a buffer that is refilled as it drains
+
+       the board size is not known until the first row has been read (see detect_board_size), so that row's numbers are
+          kept in `pending` and handed out again before the rest of the input
+       `malformed` is set (and the input treated as over) at anything that is not a number, or at a board read_board rejects
+          --- `error` then says what was wrong, for the caller to report
+    */
+
+    static constexpr size_t STREAM_CHUNK = 1 << 16; // bytes asked of read(2) per refill
+
+    int fd = -1;
+    bool owns_fd = false;
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    vector<char> buffer; // unmappable inputs only
+    const char* cursor = nullptr;
+    const char* end = nullptr;
+
+    vector<int> pending;
+    size_t next_pending = 0;
+    long long line = 1;   // line of the input the scanner is on, for error messages
+    bool malformed = false;
+    string error;
+
+    board_reader() = default;
+    board_reader(const board_reader&) = delete;
+    board_reader& operator=(const board_reader&) = delete;
+
+    ~board_reader(){
+        if(mapping != nullptr){munmap(mapping, mapping_size);}
+        if(owns_fd){close(fd);}
+    }
+
+    bool open_file(const string& path){
+        fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0){return false;}
+        owns_fd = true;
+        return attach();
+    }
+
+    bool open_descriptor(int descriptor){fd = descriptor; return attach();}
+
+    void open_memory(const char* data, size_t size){cursor = data; end = data + size;} // no mapping and no buffer: refill() never adds to it
+
+    bool attach(){ // map the input if it is a regular file, otherwise fall back to buffered reads
+        struct stat file_info;
+        if(fstat(fd, &file_info) != 0){return false;}
+        if(S_ISREG(file_info.st_mode) && file_info.st_size > 0){
+            void* mapped = mmap(nullptr, static_cast<size_t>(file_info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if(mapped != MAP_FAILED){
+                madvise(mapped, static_cast<size_t>(file_info.st_size), MADV_SEQUENTIAL);
+                mapping = mapped;
+                mapping_size = static_cast<size_t>(file_info.st_size);
+                cursor = static_cast<const char*>(mapping);
+                end = cursor + mapping_size;
+                return true;
+            }
+        }
+        buffer.resize(STREAM_CHUNK);
+        cursor = end = buffer.data();
+        return true;
+    }
+
+    bool fail(const string& message){error = message; malformed = true; return false;}
+
+    bool refill(){ // the scanner only calls this once everything before `end` is consumed
+        if(mapping != nullptr || buffer.empty()){return false;}
+        while(true){
+            ssize_t received = read(fd, buffer.data(), buffer.size());
+            if(received < 0 && errno == EINTR){continue;}
+            if(received <= 0){return false;}
+            cursor = buffer.data();
+            end = cursor + received;
+            return true;
+        }
+    }
+
+    bool next(int& value){
+        if(next_pending < pending.size()){value = pending[next_pending++]; return true;}
+        return scan(value);
+    }
+
+    bool scan(int& value){ // the next number straight from the input, past `pending`
+        if(malformed){return false;}
+
+        // skip whitespace, counting lines --- blank lines between boards need no special handling
+        while(true){
+            if(cursor == end && !refill()){return false;}
+            char c = *cursor;
+            if(c == '\n'){++line;}
+            else if(c != ' ' && c != '\t' && c != '\r' && c != '\v' && c != '\f'){break;}
+            ++cursor;
+        }
+
+        if(*cursor < '0' || *cursor > '9'){return fail("Unexpected character '" + string(1, *cursor) + "' on line " + to_string(line) + " of the input.");}
+
+        int parsed = 0;
+        while(true){
+            if(cursor == end && !refill()){break;}
+            char c = *cursor;
+            if(c < '0' || c > '9'){break;}
+            if(parsed > 1000){return fail("Number too large on line " + to_string(line) + " of the input.");} // no tile gets near this
+            parsed = parsed * 10 + (c - '0');
+            ++cursor;
+        }
+        value = parsed;
+        return true;
+    }
+
+}; // end of board_reader struct definition
+
+
+static int detect_board_size(board_reader& reader){ // start of detect_board_size function definition
+    
+    /* the board size N is the number of tiles on the first non-empty line of the input --- returns 0 if the input has no numbers */
+
+    int value;
+    if(!reader.scan(value)){return 0;}
+    long long first_line = reader.line;
+    reader.pending.push_back(value);
+
+    int row_length = 1;
+    while(reader.scan(value)){
+        reader.pending.push_back(value); // the first number of the next row is handed out again too
+        if(reader.line != first_line){break;}
+        ++row_length;
+    }
+    return row_length;
+
+} // end of detect_board_size function definition
+
+
+template<int N>
+static bool read_board(board_reader& reader, state<N>& board_state){ // start of read_board function definition
+    
+    /*
+       reads the next N*N numbers into `board_state` --- returns false when the input has no numbers left (a clean end),
+          when it runs out partway through the board, or when the numbers are not a permutation of 0..N*N-1 (exactly one blank)
+          --- the last two also mark the reader malformed
+    */
+
+    uint32_t seen = 0; // bit t set once tile t has been read --- N*N is at most 25
     for(int each_row = 0; each_row < N; ++each_row){
-        
+
         for(int each_col = 0; each_col < N; ++each_col){
+            
+            int& tile_value = board_state.board[each_row][each_col];
+            if(!reader.next(tile_value)){ // READ INTO THE BOARD
+                if(reader.malformed || (each_row == 0 && each_col == 0)){return false;}
+                return reader.fail("The input ended partway through a board, on line " + to_string(reader.line) + " (" + to_string(each_row * N + each_col) + " of " + to_string(N * N) + " tiles read).");
+            }
+
+            if(tile_value >= N * N || ((seen >> tile_value) & 1)){
+                return reader.fail("The board ending on line " + to_string(reader.line) + " of the input is not a permutation of 0-" + to_string(N * N - 1) + " with exactly one blank.");
+            }
+            seen |= uint32_t(1) << tile_value;
+
+            // record the location of the blank (represented as `0`)
+            if(tile_value == 0){
+                board_state.blank_s_row = each_row;
+                board_state.blank_s_col = each_col;
+            }
+
+        }
+    }
+
+    board_state.packed = pack_board<N>(board_state.board); // record the packed encoding used for hashing and goal testing
+    return true;
+
+} // end of read_board function definition
+
+
+template<int N>
+static bool read_in(board_reader& reader, state<N>& initial_state, state<N>& goal_state){ // start of read_in function definition
+    
+    // read in the initial state, then the goal state
+       // the blank line in the input file is skipped by the scanner like any other whitespace
+    if(!read_board(reader, initial_state) || !read_board(reader, goal_state)){
+        cerr << (reader.malformed ? reader.error : "The input file ended before both boards were read.") << endl;
+        return false;
+    }
+
+    return true;
+
+} // end of read_in function definition
+
+
+
+
+template<int N>
+static void create_output(output_writer& output, const board_grid<N>& start_board, const board_grid<N>& goal_board, int depth, long long nodes_generated, const vector<char>& actions, const vector<int>& fvalues){ // start of create_output function definition
+    
+    /* create the output files in the required format */
+
+    print_board<N>(output, start_board); // lines 1-3 of the output file
+    output.put('\n');
+    print_board<N>(output, goal_board); // lines 5-7 of the output file
+    output.put('\n');
+    output.put(depth); output.put('\n'); // line 9 of the output file
+    output.put(nodes_generated); output.put('\n'); // line 10 of the output file
+    for(size_t i = 0; i < actions.size(); ++i){output.put(actions[i]); output.put(' ');} output.put('\n'); // lines 11 of the output file
+    for(size_t i = 0; i < fvalues.size(); ++i){output.put(fvalues[i]); output.put(' ');} // lines 12 of the output file
+
+} // end of create_output function definition
+
+
+static void print_search_trace(const search_stats& stats, trace_output_kind trace_output){ // start of print_search_trace function definition
+    
+    /*
+       prints what one solve spent its work on, after the 12 output lines (--trace=text or --trace=json)
+       the hot-path counters and timings only exist in builds with -DSOLVER_TRACE; without it they are left out (text) or null (JSON)
+          so are they when the engine that ran does not record them (every engine but plain A*) --- zeros would read as measurements
+       so is the closed set for engines that keep none of their own (stats.closed_size < 0)
+    */
+
+    [[maybe_unused]] const search_trace& trace = stats.trace; // only read in -DSOLVER_TRACE builds
+    cout << '\n';
+
+    if(trace_output == TRACE_JSON){
+        cout << "{\"nodes_expanded\": " << stats.nodes_expanded << ", \"nodes_generated\": " << stats.nodes_generated << ", \"stale_entries\": " << stats.stale_entries
+             << ", \"nodes_reopened\": " << stats.nodes_reopened;
+        if(stats.closed_size >= 0){cout << ", \"closed_size\": " << stats.closed_size << ", \"table_load_factor\": " << stats.table_load_factor;}
+        else{cout << ", \"closed_size\": null, \"table_load_factor\": null";}
+#ifdef SOLVER_TRACE
+        if(trace.recorded){
+            cout << ", \"duplicate_hits\": " << trace.counters[TRACE_DUPLICATE_HITS] << ", \"decrease_keys\": " << trace.counters[TRACE_DECREASE_KEYS]
+                 << ", \"frontier_pushes\": " << trace.counters[TRACE_FRONTIER_PUSHES] << ", \"frontier_pops\": " << trace.counters[TRACE_FRONTIER_POPS]
+                 << ", \"max_frontier_size\": " << trace.max_frontier_size << ", \"heuristic_ns\": " << trace.phase_nanoseconds[TRACE_HEURISTIC]
+                 << ", \"hashing_ns\": " << trace.phase_nanoseconds[TRACE_HASHING] << ", \"queue_ns\": " << trace.phase_nanoseconds[TRACE_QUEUE] << "}\n";
+            return;
+        }
+#endif
+        cout << ", \"duplicate_hits\": null, \"decrease_keys\": null, \"frontier_pushes\": null, \"frontier_pops\": null, \"max_frontier_size\": null, \"heuristic_ns\": null, \"hashing_ns\": null, \"queue_ns\": null}\n";
+        return;
+    }
+
+    cout << "nodes expanded: " << stats.nodes_expanded << '\n'
+         << "nodes generated: " << stats.nodes_generated << '\n'
+         << "stale frontier entries: " << stats.stale_entries << '\n'
+         << "nodes re-opened: " << stats.nodes_reopened << '\n';
+    if(stats.closed_size >= 0){cout << "closed set size: " << stats.closed_size << " (table load factor " << stats.table_load_factor << ")\n";}
+    if(!search_trace::enabled){cout << "hot-path counters and timings: not built in (compile with -DSOLVER_TRACE)\n"; return;}
+#ifdef SOLVER_TRACE
+    if(!trace.recorded){return;}
+    cout << "duplicate hits: " << trace.counters[TRACE_DUPLICATE_HITS] << '\n'
+         << "decrease-keys: " << trace.counters[TRACE_DECREASE_KEYS] << '\n'
+         << "frontier pushes/pops: " << trace.counters[TRACE_FRONTIER_PUSHES] << " / " << trace.counters[TRACE_FRONTIER_POPS] << '\n'
+         << "max frontier size: " << trace.max_frontier_size << '\n'
+         << "time in heuristic/hashing/queue (us): " << trace.phase_nanoseconds[TRACE_HEURISTIC] / 1000 << " / " << trace.phase_nanoseconds[TRACE_HASHING] / 1000 << " / " << trace.phase_nanoseconds[TRACE_QUEUE] / 1000 << '\n';
+#endif
+
+} // end of print_search_trace function definition
+
+
+static void create_compact_output(output_writer& output, int depth, long long nodes_generated, const vector<char>& actions, const vector<int>& fvalues){ // start of create_compact_output function definition
+    
+    /* 
+       one line per solved instance, for batch mode: depth, nodes generated, the actions run together, the f values joined by commas
+          example: 5 12 UULDR 5,5,5,5,5,5
+       a depth-0 solve prints `-` for the actions
+    */
+
+    output.put(depth); output.put(' ');
+    output.put(nodes_generated); output.put(' ');
+    if(actions.empty()){output.put('-');}
+    for(char action : actions){output.put(action);}
+    output.put(' ');
+    for(size_t i = 0; i < fvalues.size(); ++i){
+        if(i > 0){output.put(',');}
+        output.put(fvalues[i]);
+    }
+    output.put('\n');
+
+} // end of create_compact_output function definition
+
+
+
+
+struct solver_options{ // start of solver_options struct definition
+
+    /* settings shared by the single-puzzle and batch modes, filled in from the command line */
+
+    int heuristic_choice = 1;
+    search_kind search_choice = SEARCH_A_STAR;
+    frontier_kind frontier_choice = FRONTIER_HEAP;
+    string pdb_file = "eight_puzzle.pdb";
+    bool compact_output = false; // batch mode only --- one line per instance instead of the 12-line format
+    int thread_count = 1;        // batch and daemon modes (and --search=hda) --- worker threads solving pairs in parallel
+    size_t cache_capacity = 0;   // results kept by the result cache (0 turns the cache off)
+    string cache_file;           // where the result cache is loaded from and saved to between runs (empty keeps it in memory only)
+    trace_output_kind trace_output = TRACE_OFF; // single-puzzle mode only --- print search_stats after the output
+    size_t memory_budget = 0;    // bytes the A* search may hold (0: unbounded) --- past it the frontier spills to `spill_dir`
+    string spill_dir;            // where the memory-bounded search writes its spill files
+
+}; // end of solver_options struct definition
+
+
+template<int N>
+static bool solve_puzzle(const state<N>& initial_state, const state<N>& goal_state, const solver_options& options, search_context<N>& context, search_stats& stats, vector<char>& actions, vector<int>& fvalues){ // start of solve_puzzle function definition
+    
+    /*
+       runs the search engine the user chose and fills `actions`/`fvalues` with the solution path
+       returns false if the search found no solution
+    */
+
+    if(options.search_choice == SEARCH_IDA_STAR){return ida_star_search(initial_state, goal_state, options.heuristic_choice, stats, actions, fvalues);}
+    if(options.search_choice == SEARCH_ORACLE){return oracle_search(initial_state, goal_state, options.heuristic_choice, context, stats, actions, fvalues);}
+    if(options.search_choice == SEARCH_HDA_STAR){
+        if(options.frontier_choice == FRONTIER_BUCKET){return hda_star_search<N, bucket_frontier>(initial_state, goal_state, options.heuristic_choice, options.thread_count, context, stats, actions, fvalues);}
+        return hda_star_search<N, heap_frontier>(initial_state, goal_state, options.heuristic_choice, options.thread_count, context, stats, actions, fvalues);
+    }
+    if(options.search_choice == SEARCH_BIDIRECTIONAL){
+        bool found = (options.frontier_choice == FRONTIER_BUCKET)
+            ? bidirectional_search(initial_state, goal_state, options.heuristic_choice, context.bucket_open, context.backward_bucket_open, context, stats, actions, fvalues)
+            : bidirectional_search(initial_state, goal_state, options.heuristic_choice, context.heap_open, context.backward_heap_open, context, stats, actions, fvalues);
+        stats.closed_size = static_cast<long long>(context.states.closed_count + context.backward_states.closed_count);
+        size_t total_slots = context.states.slots.size() + context.backward_states.slots.size();
+        stats.table_load_factor = total_slots == 0 ? 0.0f : static_cast<float>(context.states.used + context.backward_states.used) / total_slots;
+        return found;
+    }
+
+    if(options.memory_budget > 0){return memory_bounded_a_star(initial_state, goal_state, options.heuristic_choice, options.memory_budget, options.spill_dir, context, stats, actions, fvalues);}
+
+    uint32_t solution_id = a_star_search(initial_state, goal_state, options.heuristic_choice, options.frontier_choice, context, stats); // RUNNING THE A* SEARCH ALGORITHM
+    stats.closed_size = static_cast<long long>(context.states.closed_count);
+    stats.table_load_factor = context.states.load_factor();
+    if(solution_id == NO_NODE){return false;}
+
+    reconstruct_solution(context.arena, solution_id, actions, fvalues); // RECONSTRUCT THE SOLUTION PATH
+    return true;
+
+} // end of solve_puzzle function definition
+
+
+
+
+template<int N>
+struct result_cache{ // start of result_cache struct definition
+
+    /*
+       LRU cache of solved queries keyed by the packed (start, goal) pair, shared by every worker of a run (hence the lock)
+       a hit costs a hash lookup and a copy of the path instead of a search
+
+       a query whose reverse (goal --> start) is cached is answered from that entry too: the path is walked backwards with every move undone
+          and the f values are recomputed toward the new goal (see lookup)
+       entries only make sense for one heuristic/search/frontier setting, which is why the cache file records them and is ignored when they differ
+    */
+
+    struct cache_key{
+        board_key<N> start;
+        board_key<N> goal;
+        bool operator==(const cache_key& other) const {return start == other.start && goal == other.goal;}
+    };
+
+    struct cache_key_hash{
+        size_t operator()(const cache_key& key) const {return board_key_hash()(key.start) * 31 + board_key_hash()(key.goal);}
+    };
+
+    struct cached_result{
+        vector<char> actions;
+        vector<int> fvalues;
+        long long nodes_generated; // nodes the original search generated --- reported again on every hit, including reverse hits
+    };
+
+    using lru_list = list<pair<cache_key, cached_result>>; // most recently used at the front
+
+    size_t capacity = 0;
+    lru_list entries;
+    unordered_map<cache_key, typename lru_list::iterator, cache_key_hash> index;
+    mutex lock;
+
+    long long hits = 0;
+    long long reverse_hits = 0;
+    long long misses = 0;
+
+    bool lookup(const state<N>& initial_state, const state<N>& goal_state, int heuristic_choice, vector<char>& actions, vector<int>& fvalues, long long& nodes_generated){
+        
+        lock_guard<mutex> guard(lock);
+
+        auto found = index.find({initial_state.packed, goal_state.packed});
+        if(found != index.end()){
+            entries.splice(entries.begin(), entries, found->second); // mark as most recently used
+            const cached_result& result = found->second->second;
+            actions = result.actions;
+            fvalues = result.fvalues;
+            nodes_generated = result.nodes_generated;
+            ++hits;
+            return true;
+        }
+
+        found = index.find({goal_state.packed, initial_state.packed}); // the reverse query
+        if(found != index.end()){
+            entries.splice(entries.begin(), entries, found->second);
+            const cached_result& result = found->second->second;
+            actions.assign(result.actions.rbegin(), result.actions.rend());
+            for(char& move : actions){move = inverse_move(move);}
+            nodes_generated = result.nodes_generated;
+            ++reverse_hits;
+
+            // the stored f values aim at the other end --- recompute them toward this query's goal
+            replay_fvalues(initial_state, actions, record_goal_positions<N>(goal_state.board), heuristic_choice, fvalues);
+            return true;
+        }
+
+        ++misses;
+        return false;
+    }
+
+    void insert(board_key<N> start_key, board_key<N> goal_key, const vector<char>& actions, const vector<int>& fvalues, long long nodes_generated){
+        
+        lock_guard<mutex> guard(lock);
+
+        cache_key key = {start_key, goal_key};
+        if(index.count(key) != 0){return;} // another worker solved the same query first
+
+        entries.push_front({key, {actions, fvalues, nodes_generated}});
+        index[key] = entries.begin();
+        if(entries.size() > capacity){ // evict the least recently used result
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+
+}; // end of result_cache struct definition
+
+
+static void write_cache_header(ostream& output, const solver_options& options, int board_size){ // start of write_cache_header function definition
+    
+    /* the settings a result cache file was built with --- its entries are only reused when they match */
+
+    int32_t settings[4] = {board_size, options.heuristic_choice, static_cast<int32_t>(options.search_choice), static_cast<int32_t>(options.frontier_choice)};
+    output.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    output.write(reinterpret_cast<const char*>(settings), sizeof(settings));
+
+} // end of write_cache_header function definition
+
+
+template<int N>
+static bool unpack_board(board_key<N> packed, state<N>& board_state){ // start of unpack_board function definition
+    
+    /* the inverse of pack_board, for keys read back from a file --- returns false unless they hold a permutation of 0..N*N-1 */
+
+    const board_key<N> tile_mask = (board_key<N>(1) << board_traits<N>::TILE_BITS) - 1;
+    uint32_t seen = 0;
+    for(int cell = 0; cell < N * N; ++cell){
+        int tile_value = static_cast<int>((packed >> (cell * board_traits<N>::TILE_BITS)) & tile_mask);
+        if(tile_value >= N * N || ((seen >> tile_value) & 1)){return false;}
+        seen |= uint32_t(1) << tile_value;
+        board_state.board[cell / N][cell % N] = tile_value;
+        if(tile_value == 0){board_state.blank_s_row = cell / N; board_state.blank_s_col = cell % N;}
+    }
+    board_state.packed = packed;
+    return true;
+
+} // end of unpack_board function definition
+
+
+template<int N>
+static bool cached_result_checks_out(board_key<N> start_key, board_key<N> goal_key, const vector<char>& actions, const vector<int>& fvalues, int heuristic_choice){ // start of cached_result_checks_out function definition
+    
+    /*
+       a result read back from a cache file is only trusted if its path is made of legal moves that take the start board to the goal board
+          and its f values are the ones this heuristic gives along that path --- a stale or corrupted file must not turn into a wrong answer
+    */
+
+    state<N> initial_state{}, goal_state{};
+    if(!unpack_board<N>(start_key, initial_state) || !unpack_board<N>(goal_key, goal_state)){return false;}
+    if(fvalues.size() != actions.size() + 1){return false;}
+
+    state<N> current_state = initial_state;
+    for(char action : actions){
+        const move_table_row& legal_moves = MOVE_TABLE<N>[current_state.blank_s_row * N + current_state.blank_s_col];
+        int each_option = 0;
+        while(each_option < legal_moves.count && legal_moves.options[each_option].action != action){++each_option;}
+        if(each_option == legal_moves.count){return false;} // not a move, or one that slides the blank off the board
+        make_move(current_state, legal_moves.options[each_option].target_cell);
+    }
+    if(current_state.packed != goal_key){return false;}
+
+    vector<int> replayed;
+    replay_fvalues(initial_state, actions, record_goal_positions<N>(goal_state.board), heuristic_choice, replayed);
+    return replayed == fvalues;
+
+} // end of cached_result_checks_out function definition
+
+
+template<int N>
+static void load_result_cache(result_cache<N>& cache, const solver_options& options){ // start of load_result_cache function definition
+    
+    /*
+       reads the entries saved by save_result_cache (least recently used first, so inserting them in order restores the LRU order)
+       a missing file just means an empty cache; a file written with other settings is ignored
+       every entry is replayed before it is trusted (see cached_result_checks_out) --- the ones that do not check out are dropped
+    */
+
+    const uint32_t MAX_CACHED_DEPTH = 1 << 16; // far past any optimal path --- a larger depth means the entry is garbage and the rest of the file cannot be trusted
+
+    ifstream input(options.cache_file, ios::binary);
+    if(!input){return;}
+
+    ostringstream expected_header;
+    write_cache_header(expected_header, options, N);
+    string header(expected_header.str().size(), '\0');
+    if(!input.read(&header[0], header.size()) || header != expected_header.str()){
+        cerr << "The result cache file " << options.cache_file << " was written with other settings --- starting with an empty cache." << endl;
+        return;
+    }
+
+    board_key<N> start_key, goal_key;
+    int64_t nodes_generated;
+    uint32_t depth;
+    vector<char> actions;
+    vector<int> fvalues;
+    long long entries_dropped = 0;
+    while(input.read(reinterpret_cast<char*>(&start_key), sizeof(start_key))){
+        input.read(reinterpret_cast<char*>(&goal_key), sizeof(goal_key));
+        input.read(reinterpret_cast<char*>(&nodes_generated), sizeof(nodes_generated));
+        input.read(reinterpret_cast<char*>(&depth), sizeof(depth));
+        if(input && depth > MAX_CACHED_DEPTH){cerr << "The result cache file " << options.cache_file << " is corrupted --- keeping the entries read so far." << endl; break;}
+        actions.resize(depth);
+        fvalues.resize(depth + 1);
+        input.read(actions.data(), depth);
+        input.read(reinterpret_cast<char*>(fvalues.data()), fvalues.size() * sizeof(int));
+        if(!input){cerr << "The result cache file " << options.cache_file << " is truncated --- keeping the entries read so far." << endl; break;}
+
+        if(!cached_result_checks_out<N>(start_key, goal_key, actions, fvalues, options.heuristic_choice)){++entries_dropped; continue;}
+        cache.insert(start_key, goal_key, actions, fvalues, nodes_generated);
+    }
+    if(entries_dropped > 0){cerr << "Dropped " << entries_dropped << " result cache entries that do not replay to their goal." << endl;}
+
+} // end of load_result_cache function definition
+
+
+template<int N>
+static void save_result_cache(const result_cache<N>& cache, const solver_options& options){ // start of save_result_cache function definition
+    
+    /* writes every cached result to the cache file, least recently used first --- written to a temporary file and renamed so a crash never leaves half a cache */
+
+    string temporary_file = options.cache_file + ".tmp";
+    ofstream output(temporary_file, ios::binary);
+    if(!output){cerr << "Failed to open the result cache file for writing." << endl; return;}
+
+    write_cache_header(output, options, N);
+    for(auto entry = cache.entries.rbegin(); entry != cache.entries.rend(); ++entry){
+        const auto& [key, result] = *entry;
+        int64_t nodes_generated = result.nodes_generated;
+        uint32_t depth = static_cast<uint32_t>(result.actions.size());
+        output.write(reinterpret_cast<const char*>(&key.start), sizeof(key.start));
+        output.write(reinterpret_cast<const char*>(&key.goal), sizeof(key.goal));
+        output.write(reinterpret_cast<const char*>(&nodes_generated), sizeof(nodes_generated));
+        output.write(reinterpret_cast<const char*>(&depth), sizeof(depth));
+        output.write(result.actions.data(), depth);
+        output.write(reinterpret_cast<const char*>(result.fvalues.data()), result.fvalues.size() * sizeof(int));
+    }
+
+    output.close();
+    if(!output || rename(temporary_file.c_str(), options.cache_file.c_str()) != 0){cerr << "Failed to write the result cache file." << endl;}
+
+} // end of save_result_cache function definition
+
+
+template<int N>
+static bool solve_puzzle_cached(const state<N>& initial_state, const state<N>& goal_state, const solver_options& options, result_cache<N>* cache, search_context<N>& context, search_stats& stats, vector<char>& actions, vector<int>& fvalues){ // start of solve_puzzle_cached function definition
+    
+    /* solve_puzzle behind the result cache (nullptr when the cache is off): a hit fills in the stored result, a miss searches and stores what it found */
+
+    if(cache == nullptr){return solve_puzzle(initial_state, goal_state, options, context, stats, actions, fvalues);}
+    if(cache->lookup(initial_state, goal_state, options.heuristic_choice, actions, fvalues, stats.nodes_generated)){return true;}
+
+    if(!solve_puzzle(initial_state, goal_state, options, context, stats, actions, fvalues)){return false;}
+    cache->insert(initial_state.packed, goal_state.packed, actions, fvalues, stats.nodes_generated);
+    return true;
+
+} // end of solve_puzzle_cached function definition
+
+
+static bool parse_memory_budget(const char* text, size_t& budget){ // start of parse_memory_budget function definition
+    
+    /* reads the byte count of --memory=<bytes>[K|M|G] into `budget`; false (with a message) for anything else or a budget under 4M */
+
+    char* suffix = nullptr;
+    budget = strtoull(text, &suffix, 10);
+    switch(*suffix){ // K, M or G scale the byte count
+        case 'G': case 'g': budget <<= 10; [[fallthrough]];
+        case 'M': case 'm': budget <<= 10; [[fallthrough]];
+        case 'K': case 'k': budget <<= 10; ++suffix; break;
+        default: break;
+    }
+    if(*suffix != '\0' || budget < (size_t(4) << 20)){cerr << "--memory needs a byte count of at least 4M (K, M and G suffixes are fine)." << endl; return false;}
+    return true;
+
+} // end of parse_memory_budget function definition
+
+
+static string default_spill_dir(){ // $TMPDIR, else /tmp
+    const char* temporary = getenv("TMPDIR");
+    return (temporary != nullptr && *temporary != '\0') ? temporary : "/tmp";
+}
+
+
+static bool parse_options(int argc, char* argv[], int first_flag, const string& heuristic_arg, solver_options& options){ // start of parse_options function definition
+    
+    /* reads the heuristic choice and the optional flags from argv[first_flag] onward */
+
+    char* rest = nullptr;
+    long heuristic = strtol(heuristic_arg.c_str(), &rest, 10);
+    bool whole_number = rest != heuristic_arg.c_str() && *rest == '\0'; // the whole argument must be the number --- "2abc" is not 2
+    options.heuristic_choice = (whole_number && heuristic >= 1 && heuristic <= 3) ? static_cast<int>(heuristic) : 0;
+    if(options.heuristic_choice != 1 && options.heuristic_choice != 2 && options.heuristic_choice != 3){
+        cerr << "Invalid heuristic choice. Please enter 1, 2 or 3." << endl;
+        return false;
+    }
+
+    for(int each_arg = first_flag; each_arg < argc; ++each_arg){
+        string flag = argv[each_arg];
+        if(flag == "--search=astar"){options.search_choice = SEARCH_A_STAR;}
+        else if(flag == "--search=ida"){options.search_choice = SEARCH_IDA_STAR;}
+        else if(flag == "--search=bidir"){options.search_choice = SEARCH_BIDIRECTIONAL;}
+        else if(flag == "--search=oracle"){options.search_choice = SEARCH_ORACLE;}
+        else if(flag == "--search=hda"){options.search_choice = SEARCH_HDA_STAR;}
+        else if(flag == "--frontier=heap"){options.frontier_choice = FRONTIER_HEAP;}
+        else if(flag == "--frontier=bucket"){options.frontier_choice = FRONTIER_BUCKET;}
+        else if(flag.rfind("--pdb=", 0) == 0){options.pdb_file = flag.substr(6);}
+        else if(flag == "--compact"){options.compact_output = true;}
+        else if(flag.rfind("--cache=", 0) == 0){options.cache_capacity = strtoull(flag.c_str() + 8, nullptr, 10);}
+        else if(flag.rfind("--cache-file=", 0) == 0){options.cache_file = flag.substr(13);}
+        else if(flag == "--trace=text"){options.trace_output = TRACE_TEXT;}
+        else if(flag == "--trace=json"){options.trace_output = TRACE_JSON;}
+        else if(flag.rfind("--memory=", 0) == 0){
+            if(!parse_memory_budget(flag.c_str() + 9, options.memory_budget)){return false;}
+        }
+        else if(flag.rfind("--spill-dir=", 0) == 0){options.spill_dir = flag.substr(12);}
+        else if(flag.rfind("--threads=", 0) == 0){
+            options.thread_count = atoi(flag.c_str() + 10);
+            if(options.thread_count <= 0){options.thread_count = max(1u, thread::hardware_concurrency());} // --threads=0 means one per core
+        }
+        else{
+            cerr << "Unknown option " << flag << ". Options are --search=astar, --search=ida, --search=bidir, --search=oracle, --search=hda, --frontier=heap, --frontier=bucket, --pdb=<file>, --compact, --threads=<count>, --cache=<entries>, --cache-file=<file>, --memory=<bytes>, --spill-dir=<dir> or --trace=text|json." << endl;
+            return false;
+        }
+    }
+
+    if(!options.cache_file.empty() && options.cache_capacity == 0){cerr << "--cache-file needs --cache=<entries>." << endl; return false;}
+    if(options.memory_budget > 0 && options.search_choice != SEARCH_A_STAR){cerr << "--memory bounds the A* search only (IDA* runs in linear memory already)." << endl; return false;}
+    if(options.memory_budget > 0 && options.frontier_choice == FRONTIER_BUCKET){cerr << "--memory runs its own f-layered frontier, so it does not take --frontier=bucket." << endl; return false;}
+    if(options.spill_dir.empty()){options.spill_dir = default_spill_dir();}
+
+    bool needs_pdb = options.heuristic_choice == 3 || options.search_choice == SEARCH_ORACLE;
+    if(needs_pdb && !load_pattern_database(options.pdb_file)){return false;} // h3 and the oracle need the table mapped before any search runs
+    return true;
+
+} // end of parse_options function definition
+
+
+
+
+template<int N>
+struct batch_instance{ // start of batch_instance struct definition
+
+    /* one start/goal pair of a batch and, once a worker has solved it, its result */
+
+    state<N> initial_state;
+    state<N> goal_state;
+
+    bool unsolvable = false; // rejected by is_solvable before any search ran
+    bool solved = false;
+    int depth = 0;
+    vector<char> actions;
+    vector<int> fvalues;
+    search_stats stats;
+
+}; // end of batch_instance struct definition
+
+
+template<int N>
+static void solve_batch_instance(batch_instance<N>& instance, const solver_options& options, result_cache<N>* cache, search_context<N>& context){ // start of solve_batch_instance function definition
+    
+    /* solves one pair of a batch with the caller's (reused) search context and stores the result in the instance */
+
+    instance.stats = search_stats();
+    instance.actions.clear();
+    instance.fvalues.clear();
+    instance.solved = false;
+
+    instance.unsolvable = !is_solvable(instance.initial_state, instance.goal_state);
+    if(instance.unsolvable){return;} // no search needed
+
+    instance.solved = solve_puzzle_cached(instance.initial_state, instance.goal_state, options, cache, context, instance.stats, instance.actions, instance.fvalues);
+    instance.depth = static_cast<int>(instance.actions.size());
+
+} // end of solve_batch_instance function definition
+
+
+struct work_stealing_queue{ // start of work_stealing_queue struct definition
+
+    /*
+       one per worker thread: the owner takes instance indices from the back, idle workers steal from the front
+       each worker starts with a contiguous block of the chunk, so stealing only happens once some worker runs dry
+          (deep instances take far longer than shallow ones, so the blocks finish unevenly)
+    */
+
+    mutex lock;
+    deque<size_t> indices;
+
+    bool pop(size_t& index){ // owner side
+        lock_guard<mutex> guard(lock);
+        if(indices.empty()){return false;}
+        index = indices.back(); indices.pop_back();
+        return true;
+    }
+
+    bool steal(size_t& index){ // thief side
+        lock_guard<mutex> guard(lock);
+        if(indices.empty()){return false;}
+        index = indices.front(); indices.pop_front();
+        return true;
+    }
+
+}; // end of work_stealing_queue struct definition
+
+
+template<int N>
+static void solve_batch_chunk(vector<batch_instance<N>>& chunk, size_t chunk_size, const solver_options& options, result_cache<N>* cache, vector<search_context<N>>& contexts){ // start of solve_batch_chunk function definition
+    
+    /* solves the first `chunk_size` instances of `chunk`, one worker thread per search context; results land in the instances so the output order is untouched */
+
+    int worker_count = static_cast<int>(contexts.size());
+    if(worker_count == 1){
+        for(size_t each_instance = 0; each_instance < chunk_size; ++each_instance){solve_batch_instance(chunk[each_instance], options, cache, contexts[0]);}
+        return;
+    }
+
+    // deal the chunk out in contiguous blocks
+    vector<work_stealing_queue> queues(worker_count);
+    for(size_t each_instance = 0; each_instance < chunk_size; ++each_instance){
+        queues[each_instance * worker_count / chunk_size].indices.push_back(each_instance);
+    }
+
+    auto worker = [&](int worker_id){
+        size_t index;
+        while(true){
+            if(queues[worker_id].pop(index)){solve_batch_instance(chunk[index], options, cache, contexts[worker_id]); continue;}
+
+            // own queue is empty --- try to steal from the others, starting with the next worker over
+            bool stole = false;
+            for(int offset = 1; offset < worker_count && !stole; ++offset){stole = queues[(worker_id + offset) % worker_count].steal(index);}
+            if(!stole){return;} // every queue is empty --- nothing new is ever added during a chunk, so we are done
+            solve_batch_instance(chunk[index], options, cache, contexts[worker_id]);
+        }
+    };
+
+    vector<thread> workers;
+    for(int worker_id = 1; worker_id < worker_count; ++worker_id){workers.emplace_back(worker, worker_id);}
+    worker(0); // the calling thread works too
+    for(thread& each_worker : workers){each_worker.join();}
+
+} // end of solve_batch_chunk function definition
+
+
+template<int N>
+static int run_batch(board_reader& input, const solver_options& options){ // start of run_batch function definition
+    
+    /*
+       batch mode: solves start/goal pairs streamed from `input` until it runs out (same layout as the single-puzzle file, pairs back to back)
+          every pair of one batch has the same board size N
+
+       the input is consumed in chunks; each chunk is solved by `thread_count` workers, each owning one search_context
+          (arena slabs, frontier and hash tables) that it reuses for every pair it solves over the whole batch
+       results are written chunk by chunk in input order, so the output does not depend on the thread count
+
+       output per pair is the usual 12-line block followed by a blank line, or one line with --compact
+          a pair that fails the parity pre-check prints `unsolvable` in place of its block/line
+          with --memory, a pair whose search ran out of the budget prints `out of memory` (or `spill failed` if a spill file could not be written or read)
+          a malformed board (see read_board), or a start board with no goal after it, ends the batch with status 1 once the pairs before it have been answered
+    */
 
-            input_file >> goal_state.board[each_row][each_col]; // READ INTO THE GOAL STATE BOARD
+    const size_t CHUNK_PER_THREAD = 1024; // pairs read per worker before solving --- bounds memory on arbitrarily long inputs
+
+    vector<search_context<N>> contexts(options.thread_count);
+    vector<batch_instance<N>> chunk(CHUNK_PER_THREAD * options.thread_count); // reused for every chunk, including each instance's result buffers
+    long long instances_solved = 0;
+    long long instances_unsolvable = 0;
+    long long instances_out_of_memory = 0; // --memory only: out of budget, or a spill file failed
+    search_stats batch_totals;
+
+    result_cache<N> cache;
+    cache.capacity = options.cache_capacity;
+    if(!options.cache_file.empty()){load_result_cache(cache, options);}
+    result_cache<N>* cache_in_use = (options.cache_capacity > 0) ? &cache : nullptr;
+
+    output_writer output(STDOUT_FILENO);
+    bool input_left = true;
+    while(input_left){ // start of processing each chunk
+
+        // read the next chunk of pairs
+        size_t chunk_size = 0;
+        while(chunk_size < chunk.size()){
+            batch_instance<N>& instance = chunk[chunk_size];
+            if(!read_board(input, instance.initial_state)){
+                if(input.malformed){cerr << input.error << endl;}
+                input_left = false;
+                break;
+            }
+            if(!read_board(input, instance.goal_state)){ // the pairs before the bad board or the dangling start board are still answered
+                if(!input.malformed){input.fail("The batch input ended in the middle of a start/goal pair.");}
+                cerr << input.error << endl;
+                input_left = false;
+                break;
+            }
+            ++chunk_size;
+        }
+        if(chunk_size == 0){break;}
 
-            // record the location of the blank (represented as `0`)
-            if(goal_state.board[each_row][each_col] == 0){
-                goal_state.blank_s_row = each_row;
-                goal_state.blank_s_col = each_col;
+        solve_batch_chunk(chunk, chunk_size, options, cache_in_use, contexts);
+
+        for(size_t each_instance = 0; each_instance < chunk_size; ++each_instance){ // write the results in input order
+
+            const batch_instance<N>& instance = chunk[each_instance];
+
+            if(instance.unsolvable){output.put(options.compact_output ? "unsolvable\n" : "unsolvable\n\n");}
+            else if(!instance.solved && instance.stats.memory_exhausted){output.put(options.compact_output ? "out of memory\n" : "out of memory\n\n");}
+            else if(!instance.solved && instance.stats.spill_failed){output.put(options.compact_output ? "spill failed\n" : "spill failed\n\n");}
+            else if(!instance.solved){output.put(options.compact_output ? "no solution\n" : "no solution\n\n");}
+            else if(options.compact_output){create_compact_output(output, instance.depth, instance.stats.nodes_generated, instance.actions, instance.fvalues);}
+            else{
+                create_output<N>(output, instance.initial_state.board, instance.goal_state.board, instance.depth, instance.stats.nodes_generated, instance.actions, instance.fvalues);
+                output.put("\n\n"); // end line 12 and leave a blank line before the next block
             }
+
+            instances_solved += instance.solved;
+            instances_unsolvable += instance.unsolvable;
+            instances_out_of_memory += !instance.solved && (instance.stats.memory_exhausted || instance.stats.spill_failed);
+            batch_totals.stale_entries += instance.stats.stale_entries;
+            batch_totals.nodes_reopened += instance.stats.nodes_reopened;
         }
+
+    } // end of processing each chunk
+
+    output.flush();
+    cerr << "instances solved: " << instances_solved << ", unsolvable: " << instances_unsolvable;
+    if(options.memory_budget > 0){cerr << ", out of memory or spill failed: " << instances_out_of_memory;}
+    cerr << ", stale frontier entries skipped: " << batch_totals.stale_entries << ", nodes re-opened: " << batch_totals.nodes_reopened << endl;
+    if(cache_in_use != nullptr){
+        cerr << "result cache hits: " << cache.hits << ", reverse hits: " << cache.reverse_hits << ", misses: " << cache.misses << endl;
+        if(!options.cache_file.empty()){save_result_cache(cache, options);}
     }
+    return input.malformed ? 1 : 0; // a bad board ends the batch --- everything before it has been answered
 
+} // end of run_batch function definition
 
-    // done reading in the input file
-    input_file.close();
-    return true;
 
-} // end of read_in function definition
+template<int N>
+static int run_single(board_reader& input, const solver_options& options){ // start of run_single function definition
+    
+    /* single-puzzle mode: one start/goal pair, answered in the 12-line output format */
+
+    // read in 
+    state<N> initial_state{}, goal_state{}; // initialze empty `state` instances
+    if(!read_in(input, initial_state, goal_state)){
+        cerr << "Read in failed. Please retry." << endl;
+        return 1;
+    }
+
+
+
+    // reaching here means we have successfuly read-in
+
+    if(!is_solvable(initial_state, goal_state)){ // parity pre-check --- no search can reach this goal
+        cerr << "The goal state cannot be reached from the initial state." << endl;
+        return EXIT_UNSOLVABLE;
+    }
+
+    result_cache<N> cache; // only useful with --cache-file: it carries results over from earlier runs
+    cache.capacity = options.cache_capacity;
+    if(!options.cache_file.empty()){load_result_cache(cache, options);}
+    result_cache<N>* cache_in_use = (options.cache_capacity > 0) ? &cache : nullptr;
+
+    // run the search (A* unless --search says otherwise) and reconstruct the solution path
+    search_stats stats;
+    search_context<N> context; // owns every node and table of this search
+    vector<char> actions;
+    vector<int> fvalues;
+    bool found = solve_puzzle_cached(initial_state, goal_state, options, cache_in_use, context, stats, actions, fvalues); // RUNNING THE SEARCH
+    context.arena.release(); // the path has been copied out --- free the whole search tree in one shot
+
+    if(!found && stats.memory_exhausted){
+        cerr << "Out of memory: no solution within --memory=" << options.memory_budget << " bytes. After " << stats.nodes_expanded << " expansions the table is full of explored boards,"
+             << " which cannot be spilled, and has no room left for new ones." << endl;
+        return EXIT_OUT_OF_MEMORY;
+    }
+    if(!found && stats.spill_failed){return 1;} // memory_bounded_a_star has said what failed
+    if(!found){cerr << "No solution found." << endl; return 1;} // only reachable with malformed boards --- the parity check rules out the rest
+
 
+    int depth = static_cast<int>(actions.size()); // the depth of the solution path is the number of actions taken
+
+    output_writer output(STDOUT_FILENO);
+    create_output<N>(output, initial_state.board, goal_state.board, depth, stats.nodes_generated, actions, fvalues); // GENERATE THE OUTPUT FILES
+    output.flush(); // the trace goes through cout, after the 12 lines
+    if(options.trace_output != TRACE_OFF){print_search_trace(stats, options.trace_output);}
+
+    cerr << "stale frontier entries skipped: " << stats.stale_entries << ", nodes re-opened: " << stats.nodes_reopened; // frontier bookkeeping, kept off the output file
+    if(options.memory_budget > 0){cerr << ", frontier records spilled: " << stats.frontier_spilled;}
+    cerr << endl;
+    if(cache_in_use != nullptr){
+        cerr << "result cache hits: " << cache.hits << ", reverse hits: " << cache.reverse_hits << ", misses: " << cache.misses << endl;
+        if(!options.cache_file.empty()){save_result_cache(cache, options);}
+    }
+
+    return 0;
+
+} // end of run_single function definition
+
+
+
+/* =============================================== BENCHMARK =============================================== */
+
+
+struct benchmark_engine{ // one search setup the benchmark can time
+    const char* name;
+    search_kind search_choice;
+    frontier_kind frontier_choice;
+    bool memory_bounded = false; // A* within the benchmark's --memory budget
+};
+
+const benchmark_engine BENCHMARK_ENGINES[] = {
+    {"astar-heap", SEARCH_A_STAR, FRONTIER_HEAP},
+    {"astar-bucket", SEARCH_A_STAR, FRONTIER_BUCKET},
+    {"ida", SEARCH_IDA_STAR, FRONTIER_HEAP},
+    {"bidir", SEARCH_BIDIRECTIONAL, FRONTIER_HEAP},
+    {"oracle", SEARCH_ORACLE, FRONTIER_HEAP}, // h3 only --- the walk is the same whatever heuristic the f values use
+    {"hda", SEARCH_HDA_STAR, FRONTIER_HEAP},  // over the benchmark's --threads; reported as hda-t<threads>
+    {"astar-memory", SEARCH_A_STAR, FRONTIER_HEAP, true} // reported as astar-memory-<budget>
+};
+
+
+struct benchmark_options{ // start of benchmark_options struct definition
+
+    /* settings of --bench, filled in from the command line */
+
+    int board_size = 0;          // size of the generated suite (0 when the suite is loaded from `suite_file`)
+    string suite_file;           // batch-format file holding the suite to time
+    uint32_t seed = 1;           // seed of the generated suite --- the same seed always gives the same suite
+    int per_depth = 10;          // generated instances per optimal depth
+    int max_depth = -1;          // deepest generated instance (-1 picks 31, 30 or 20 for 3x3, 4x4 or 5x5)
+    string save_suite;           // write the generated suite here so later builds can be timed on it with --bench <file>
+    bool json_output = false;    // JSON instead of CSV
+    string pdb_file = "eight_puzzle.pdb";
+    vector<int> heuristics = {1, 2, 3};
+    vector<string> engines = {"astar-heap", "astar-bucket", "ida", "bidir", "oracle", "hda", "astar-memory"};
+    int thread_count = 4;              // threads of the hda engine
+    size_t memory_budget = 64 << 20;   // byte budget of the astar-memory engine
+    string memory_label = "64M";       // that budget as it was given, for the engine column
+    string spill_dir = default_spill_dir();
 
+}; // end of benchmark_options struct definition
 
 
-static void create_output(const array<array<int,N>, N>& start_board, const array<array<int,N>, N>& goal_board, int depth, long long nodes_generated, vector<char>& actions, vector<int>& fvalues){ // start of create_output function definition
+template<int N>
+static void generate_benchmark_suite(const benchmark_options& bench, int max_depth, vector<pair<state<N>, state<N>>>& suite){ // start of generate_benchmark_suite function definition
     
-    /* create the output files in the required format */
+    /*
+       fills `suite` with up to `per_depth` instances for every optimal depth 0..max_depth, all aiming at the usual goal (tiles in order, blank last)
+       starts come from random walks off the goal (a fixed-seed mt19937, so the suite is reproducible); each walk's optimal depth is found by IDA* with h2
+          and the instance is kept if its depth bucket still has room
+       the deepest buckets are rare (the 8-puzzle has only 2 states at depth 31), so walks stop after a fixed budget and short buckets are reported
+    */
 
-    print_board(start_board); // lines 1-3 of the output file
-    cout << '\n';
-    print_board(goal_board); // lines 5-7 of the output file
-    cout << '\n';
-    cout << depth << '\n'; // line 9 of the output file
-    cout << nodes_generated << '\n'; // line 10 of the output file
-    for(int i = 0; i < actions.size(); ++i){cout << actions[i] << ' ';} cout << '\n'; // lines 11 of the output file
-    for(int i = 0; i < fvalues.size(); ++i){cout << fvalues[i] << ' ';} // lines 12 of the output file
+    state<N> goal_state{};
+    for(int each_cell = 0; each_cell < N * N; ++each_cell){goal_state.board[each_cell / N][each_cell % N] = (each_cell + 1) % (N * N);}
+    goal_state.blank_s_row = N - 1;
+    goal_state.blank_s_col = N - 1;
+    goal_state.packed = pack_board<N>(goal_state.board);
+
+    solver_options labeller; // labels each walk with its optimal depth
+    labeller.heuristic_choice = 2;
+    labeller.search_choice = SEARCH_IDA_STAR;
+    search_context<N> context;
+
+    mt19937 generator(bench.seed);
+    vector<int> bucket_sizes(max_depth + 1, 0);
+    int buckets_left = max_depth + 1;
+    long long walks_left = 200LL * bench.per_depth * (max_depth + 1);
+
+    while(buckets_left > 0 && walks_left-- > 0){ // start of each random walk
+
+        state<N> start_state = goal_state;
+        int walk_length = generator() % (max_depth + max_depth / 2 + 1);
+        char last_move = '\0';
+        for(int each_step = 0; each_step < walk_length; ++each_step){
+            const move_table_row& legal_moves = MOVE_TABLE<N>[start_state.blank_s_row * N + start_state.blank_s_col];
+            const move_option* option;
+            do{option = &legal_moves.options[generator() % legal_moves.count];} while(option->action == inverse_move(last_move)); // no immediate backtracking
+            make_move(start_state, option->target_cell);
+            last_move = option->action;
+        }
 
-} // end of create_output function definition
+        search_stats stats;
+        vector<char> actions;
+        vector<int> fvalues;
+        solve_puzzle(start_state, goal_state, labeller, context, stats, actions, fvalues);
+        int depth = static_cast<int>(actions.size());
+        if(depth > max_depth || bucket_sizes[depth] == bench.per_depth){continue;}
+
+        suite.push_back({start_state, goal_state});
+        if(++bucket_sizes[depth] == bench.per_depth){--buckets_left;}
 
+    } // end of each random walk
 
+    for(int depth = 0; depth <= max_depth; ++depth){
+        if(bucket_sizes[depth] < bench.per_depth){cerr << "benchmark suite: depth " << depth << " has " << bucket_sizes[depth] << " of " << bench.per_depth << " instances" << endl;}
+    }
 
+} // end of generate_benchmark_suite function definition
 
 
+struct benchmark_sample{ // the measurements of one solve
+    int depth;
+    long long nodes_expanded;
+    long long nodes_generated;
+    double microseconds;
+};
 
-int main(int argc, char* argv[]){ // start of main function
-                                      // WHERE ALL THE ACTION OCCURS
 
-    // checking correct command line arguments
-        // the source code
-        // the input file
-        // the heuristic choice
-    if(argc != 3){
-        cerr << "Wrong number of arguments. Please enter the input file and the heuristic choice." << endl;
-        return 1;
+static void write_benchmark_row(const benchmark_options& bench, int board_size, int heuristic_choice, const char* engine, const string& depth, vector<benchmark_sample>& samples, long peak_rss_kb, bool& first_row){ // start of write_benchmark_row function definition
+    
+    /* aggregates the samples of one (heuristic, engine, depth) cell into one CSV line or JSON object */
+
+    sort(samples.begin(), samples.end(), [](const benchmark_sample& s1, const benchmark_sample& s2){return s1.microseconds < s2.microseconds;});
+    auto percentile = [&](double fraction){ // nearest-rank percentile of the wall times
+        size_t rank = static_cast<size_t>(ceil(fraction * samples.size()));
+        return samples[rank == 0 ? 0 : rank - 1].microseconds;
+    };
+
+    double total_expanded = 0, total_generated = 0, total_microseconds = 0;
+    for(const benchmark_sample& sample : samples){
+        total_expanded += sample.nodes_expanded;
+        total_generated += sample.nodes_generated;
+        total_microseconds += sample.microseconds;
+    }
+    double count = static_cast<double>(samples.size());
+    double nodes_per_second = (total_microseconds > 0) ? total_generated / (total_microseconds / 1e6) : 0;
+
+    if(bench.json_output){
+        cout << (first_row ? "\n" : ",\n")
+             << "    {\"board_size\": " << board_size << ", \"heuristic\": " << heuristic_choice << ", \"engine\": \"" << engine << "\", \"depth\": \"" << depth << "\""
+             << ", \"instances\": " << samples.size() << ", \"nodes_expanded_mean\": " << total_expanded / count << ", \"nodes_generated_mean\": " << total_generated / count
+             << ", \"nodes_per_second\": " << nodes_per_second << ", \"wall_us_p50\": " << percentile(0.5) << ", \"wall_us_p90\": " << percentile(0.9)
+             << ", \"wall_us_p99\": " << percentile(0.99) << ", \"wall_us_max\": " << samples.back().microseconds << ", \"peak_rss_kb\": " << peak_rss_kb << "}";
     }
+    else{
+        cout << board_size << ',' << heuristic_choice << ',' << engine << ',' << depth << ',' << samples.size() << ',' << total_expanded / count << ',' << total_generated / count << ','
+             << nodes_per_second << ',' << percentile(0.5) << ',' << percentile(0.9) << ',' << percentile(0.99) << ',' << samples.back().microseconds << ',' << peak_rss_kb << '\n';
+    }
+    first_row = false;
 
+} // end of write_benchmark_row function definition
 
-    // grab the command line arguments
-       // there should be two arguments: the input file and the heuristic choice
-    string input_file = argv[1];
-    int h = stoi(argv[2]);
-    if(h != 1 && h != 2){
-        cerr << "Invalid heuristic choice. Please enter 1 or 2." << endl;
-        return 1;
+
+template<int N>
+static int run_benchmark(board_reader* suite_input, const benchmark_options& bench){ // start of run_benchmark function definition
+    
+    /*
+       benchmark mode: times every chosen (heuristic, engine) pair on one suite of instances --- loaded from a batch-format file or generated
+       results go to stdout, one row per optimal depth plus an `all` row per pair, as CSV or JSON
+
+       each pair reuses one search context over the suite, like a batch worker does, and each solve is timed on its own (steady clock)
+       peak_rss_kb is the process's high-water mark (getrusage) once that pair has finished --- it never goes down, so read it in run order
+    */
+
+    vector<pair<state<N>, state<N>>> suite;
+    if(suite_input != nullptr){
+        state<N> initial_state{}, goal_state{};
+        while(read_board(*suite_input, initial_state)){
+            if(!read_board(*suite_input, goal_state)){
+                cerr << (suite_input->malformed ? suite_input->error : "The benchmark suite ended in the middle of a start/goal pair.") << endl;
+                return 1;
+            }
+            if(!is_solvable(initial_state, goal_state)){cerr << "The benchmark suite holds an unsolvable pair." << endl; return 1;}
+            suite.push_back({initial_state, goal_state});
+        }
+        if(suite_input->malformed){cerr << suite_input->error << endl; return 1;}
+    }
+    else{
+        int max_depth = (bench.max_depth >= 0) ? bench.max_depth : (N == 3 ? 31 : N == 4 ? 30 : 20);
+        generate_benchmark_suite(bench, max_depth, suite);
+    }
+    if(suite.empty()){cerr << "The benchmark suite is empty." << endl; return 1;}
+
+    if(!bench.save_suite.empty()){
+        ofstream suite_output(bench.save_suite);
+        for(const auto& [initial_state, goal_state] : suite){
+            for(const state<N>* board_state : {&initial_state, &goal_state}){
+                for(int each_row = 0; each_row < N; ++each_row){
+                    for(int each_col = 0; each_col < N; ++each_col){suite_output << (each_col > 0 ? " " : "") << board_state->board[each_row][each_col];}
+                    suite_output << '\n';
+                }
+                suite_output << '\n';
+            }
+        }
+        if(!suite_output){cerr << "Failed to write the benchmark suite file." << endl; return 1;}
     }
 
-    // read in 
-    state initial_state{}, goal_state{}; // initialze empty `state` instances
-    if(!read_in(input_file, initial_state, goal_state)){
-        cerr << "Read in failed. Please retry." << endl;
-        return 1;
+    bool pdb_ready = (N * N == PDB_CELLS) && load_pattern_database(bench.pdb_file);
+
+    cout << fixed << setprecision(1);
+    if(bench.json_output){cout << "{\"instances\": " << suite.size() << ", \"results\": [";}
+    else{cout << "board_size,heuristic,engine,depth,instances,nodes_expanded_mean,nodes_generated_mean,nodes_per_second,wall_us_p50,wall_us_p90,wall_us_p99,wall_us_max,peak_rss_kb\n";}
+    bool first_row = true;
+
+    search_context<N> context;
+    for(int heuristic_choice : bench.heuristics){
+        for(const benchmark_engine& engine : BENCHMARK_ENGINES){ // start of timing one (heuristic, engine) pair
+
+            if(find(bench.engines.begin(), bench.engines.end(), engine.name) == bench.engines.end()){continue;}
+            bool uses_pdb = heuristic_choice == 3 || engine.search_choice == SEARCH_ORACLE;
+            if(uses_pdb && !pdb_ready){continue;} // needs the 3x3 pattern database
+            if(engine.search_choice == SEARCH_ORACLE && heuristic_choice != 3){continue;}
+
+            solver_options options;
+            options.heuristic_choice = heuristic_choice;
+            options.search_choice = engine.search_choice;
+            options.frontier_choice = engine.frontier_choice;
+            options.thread_count = bench.thread_count;
+            options.spill_dir = bench.spill_dir;
+            string engine_label = engine.name;
+            if(engine.search_choice == SEARCH_HDA_STAR){engine_label += "-t" + to_string(bench.thread_count);}
+            if(engine.memory_bounded){options.memory_budget = bench.memory_budget; engine_label += "-" + bench.memory_label;}
+
+            vector<benchmark_sample> samples;
+            size_t unsolved = 0; // instances the memory-bounded engine ran out of budget (or spill space) on
+            for(const auto& [initial_state, goal_state] : suite){
+                search_stats stats;
+                vector<char> actions;
+                vector<int> fvalues;
+                auto started = chrono::steady_clock::now();
+                bool found = solve_puzzle(initial_state, goal_state, options, context, stats, actions, fvalues);
+                chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - started;
+                if(!found){++unsolved; continue;}
+                samples.push_back({static_cast<int>(actions.size()), stats.nodes_expanded, stats.nodes_generated, elapsed.count()});
+            }
+            if(unsolved > 0){cerr << "benchmark: " << engine_label << " with h" << heuristic_choice << " solved " << samples.size() << " of " << suite.size() << " instances; the rest are left out of its rows" << endl;}
+            if(samples.empty()){continue;}
+
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+
+            // one row per depth, then the whole suite
+            map<int, vector<benchmark_sample>> by_depth;
+            for(const benchmark_sample& sample : samples){by_depth[sample.depth].push_back(sample);}
+            for(auto& [depth, depth_samples] : by_depth){write_benchmark_row(bench, N, heuristic_choice, engine_label.c_str(), to_string(depth), depth_samples, usage.ru_maxrss, first_row);}
+            write_benchmark_row(bench, N, heuristic_choice, engine_label.c_str(), "all", samples, usage.ru_maxrss, first_row);
+            cout.flush();
+
+        } // end of timing one (heuristic, engine) pair
     }
 
+    if(bench.json_output){cout << "\n]}\n";}
+    return 0;
+
+} // end of run_benchmark function definition
 
 
-    // reaching here means we have successfuly read-in
+static bool parse_benchmark_options(int argc, char* argv[], benchmark_options& bench){ // start of parse_benchmark_options function definition
+    
+    /* reads `--bench <3|4|5 or suite file>` and the benchmark flags after it */
+
+    string suite = argv[2];
+    if(suite == "3" || suite == "4" || suite == "5"){bench.board_size = atoi(suite.c_str());}
+    else{bench.suite_file = suite;}
+
+    auto split_list = [](const string& list){ // comma-separated values
+        vector<string> values;
+        stringstream list_stream(list);
+        string value;
+        while(getline(list_stream, value, ',')){values.push_back(value);}
+        return values;
+    };
 
+    for(int each_arg = 3; each_arg < argc; ++each_arg){
+        string flag = argv[each_arg];
+        if(flag.rfind("--seed=", 0) == 0){bench.seed = static_cast<uint32_t>(strtoul(flag.c_str() + 7, nullptr, 10));}
+        else if(flag.rfind("--per-depth=", 0) == 0){bench.per_depth = max(1, atoi(flag.c_str() + 12));}
+        else if(flag.rfind("--max-depth=", 0) == 0){bench.max_depth = atoi(flag.c_str() + 12);}
+        else if(flag.rfind("--save-suite=", 0) == 0){bench.save_suite = flag.substr(13);}
+        else if(flag == "--format=csv"){bench.json_output = false;}
+        else if(flag == "--format=json"){bench.json_output = true;}
+        else if(flag.rfind("--pdb=", 0) == 0){bench.pdb_file = flag.substr(6);}
+        else if(flag.rfind("--heuristics=", 0) == 0){
+            bench.heuristics.clear();
+            for(const string& value : split_list(flag.substr(13))){bench.heuristics.push_back(atoi(value.c_str()));}
+        }
+        else if(flag.rfind("--engines=", 0) == 0){
+            bench.engines = split_list(flag.substr(10));
+            for(const string& name : bench.engines){
+                bool known = any_of(begin(BENCHMARK_ENGINES), end(BENCHMARK_ENGINES), [&](const benchmark_engine& engine){return name == engine.name;});
+                if(!known){cerr << "Unknown benchmark engine " << name << ". Engines are astar-heap, astar-bucket, ida, bidir, oracle, hda and astar-memory." << endl; return false;}
+            }
+        }
+        else if(flag.rfind("--threads=", 0) == 0){
+            bench.thread_count = atoi(flag.c_str() + 10);
+            if(bench.thread_count <= 0){bench.thread_count = max(1u, thread::hardware_concurrency());} // --threads=0 means one per core
+        }
+        else if(flag.rfind("--memory=", 0) == 0){
+            if(!parse_memory_budget(flag.c_str() + 9, bench.memory_budget)){return false;}
+            bench.memory_label = flag.substr(9);
+        }
+        else if(flag.rfind("--spill-dir=", 0) == 0){bench.spill_dir = flag.substr(12);}
+        else{
+            cerr << "Unknown benchmark option " << flag << ". Options are --seed=<n>, --per-depth=<n>, --max-depth=<n>, --save-suite=<file>, --format=csv|json, --pdb=<file>, --heuristics=<list>, --engines=<list>,"
+                 << " --threads=<count> (hda), --memory=<bytes> (astar-memory) or --spill-dir=<dir>." << endl;
+            return false;
+        }
+    }
+    return true;
 
-    // run the A* search algorithm
-    long long nodes_generated = 0;
-    const Node* solution_node = a_star_search(initial_state, goal_state, h, nodes_generated); // RUNNING THE A* SEARCH ALGORITHM
+} // end of parse_benchmark_options function definition
 
 
+static int run_benchmark_for_board_size(const benchmark_options& bench){ // start of run_benchmark_for_board_size function definition
     
+    /* picks the compiled instantiation for the suite: the size asked for, or the size read off the suite file's first row */
+
+    int board_size = bench.board_size;
+    board_reader reader;
+    if(!bench.suite_file.empty()){
+        if(!reader.open_file(bench.suite_file)){cerr << "Failed to open the benchmark suite file." << endl; return 1;}
+        board_size = detect_board_size(reader);
+        if(reader.malformed){cerr << reader.error << endl; return 1;}
+        if(board_size < MIN_BOARD_SIZE || board_size > MAX_BOARD_SIZE){cerr << "Unsupported board size " << board_size << " in the benchmark suite." << endl; return 1;}
+    }
+    board_reader* suite_reader = bench.suite_file.empty() ? nullptr : &reader;
+
+    switch(board_size){
+        case 3: return run_benchmark<3>(suite_reader, bench);
+        case 4: return run_benchmark<4>(suite_reader, bench);
+        default: return run_benchmark<5>(suite_reader, bench);
+    }
 
-    /* preparation for the output files */
+} // end of run_benchmark_for_board_size function definition
 
-    vector<char> actions;
-    vector<int> fvalues;
-    reconstruct_solution(solution_node, actions, fvalues); // RECONSTRUCT THE SOLUTION PATH
 
+/* =============================================== SOLVER DAEMON =============================================== */
 
-    int depth = static_cast<int>(actions.size()); // the depth of the solution path is the number of actions taken
 
-    create_output(initial_state.board, goal_state.board, depth, nodes_generated, actions, fvalues); // GENERATE THE OUTPUT FILES
+/*
+   --serve <socket path> <heuristic choice> [flags]: a long-running solver answering queries over a Unix domain socket,
+      so a lookup costs a solve instead of a process start plus cold tables
+
+   protocol (text, one request per line, any number of requests in flight on a connection):
+      request:   the start board's tiles then the goal board's tiles, row-major, separated by whitespace --- 18 numbers for 3x3, 32 for 4x4, 50 for 5x5
+                    example: 2 8 3 1 6 4 7 0 5 1 2 3 8 0 4 7 6 5
+                 blank lines are skipped
+      response:  one line per request, in request order: the --compact line (depth, nodes generated, actions, f values),
+                    `unsolvable`, `no solution`, `out of memory` (--memory ran out) or `error <reason>`
+
+   one thread runs the epoll loop (accepting, reading and splitting requests, writing replies); --threads solver workers take the requests
+      from a shared queue, each with its own search context per board size that stays warm across requests (as do the pattern database,
+      the conflict tables and the --cache result cache, which all workers share)
+   SIGINT/SIGTERM stop the daemon and remove the socket file
+*/
+
+const size_t SERVE_MAX_LINE = 4096; // longest request line accepted --- a 5x5 request is well under 200 bytes
+
+
+struct serve_job{ // one request line waiting for a worker
+    uint64_t connection;
+    uint64_t sequence; // position of the request on its connection
+    string request;
+};
+
+struct serve_reply{ // one finished reply waiting for the event loop
+    uint64_t connection;
+    uint64_t sequence;
+    string text;
+};
+
+
+struct serve_state{ // start of serve_state struct definition
+
+    /* what the event loop and the solver workers share */
+
+    const solver_options* options;
+
+    mutex jobs_lock;
+    condition_variable jobs_ready;
+    deque<serve_job> jobs;
+    bool stopping = false;
+
+    mutex replies_lock;
+    vector<serve_reply> replies;
+    int wake_fd = -1;                  // eventfd the workers poke when replies are waiting
+    atomic<bool> wake_pending{false};  // set by the first reply since the loop last drained --- later ones skip the syscall
+
+    result_cache<3> cache_3;
+    result_cache<4> cache_4;
+    result_cache<5> cache_5;
+
+    template<int N>
+    result_cache<N>* cache(){
+        if(options->cache_capacity == 0){return nullptr;}
+        if constexpr(N == 3){return &cache_3;}
+        else if constexpr(N == 4){return &cache_4;}
+        else{return &cache_5;}
+    }
+
+}; // end of serve_state struct definition
 
+
+struct serve_worker{ // start of serve_worker struct definition
+
+    /* one solver thread's reusable state --- a size's context and instance are only built once a request of that size arrives */
+
+    unique_ptr<search_context<3>> context_3;
+    unique_ptr<search_context<4>> context_4;
+    unique_ptr<search_context<5>> context_5;
+    unique_ptr<batch_instance<3>> instance_3;
+    unique_ptr<batch_instance<4>> instance_4;
+    unique_ptr<batch_instance<5>> instance_5;
+
+    template<int N>
+    pair<search_context<N>&, batch_instance<N>&> slot(){
+        auto pick = [](auto& context, auto& instance){
+            if(!context){context = make_unique<typename remove_reference_t<decltype(context)>::element_type>();}
+            if(!instance){instance = make_unique<typename remove_reference_t<decltype(instance)>::element_type>();}
+            return pair<search_context<N>&, batch_instance<N>&>(*context, *instance);
+        };
+        if constexpr(N == 3){return pick(context_3, instance_3);}
+        else if constexpr(N == 4){return pick(context_4, instance_4);}
+        else{return pick(context_5, instance_5);}
+    }
+
+}; // end of serve_worker struct definition
+
+
+template<int N>
+static void answer_serve_request(board_reader& request, serve_state& shared, serve_worker& worker, output_writer& reply){ // start of answer_serve_request function definition
+    
+    /* solves one request whose numbers are already in request.pending and writes its reply line --- the same work and format as a --compact batch pair */
+
+    const solver_options& options = *shared.options;
+    if((options.heuristic_choice == 3 || options.search_choice == SEARCH_ORACLE) && N * N != PDB_CELLS){
+        reply.put("error The pattern database (h3 and --search=oracle) only covers 3x3 boards.\n");
+        return;
+    }
+
+    auto [context, instance] = worker.slot<N>();
+    if(!read_board(request, instance.initial_state) || !read_board(request, instance.goal_state)){
+        reply.put("error "); reply.put(request.error.c_str()); reply.put('\n');
+        return;
+    }
+
+    solve_batch_instance(instance, options, shared.cache<N>(), context);
+
+    if(instance.unsolvable){reply.put("unsolvable\n");}
+    else if(!instance.solved && instance.stats.memory_exhausted){reply.put("out of memory\n");}
+    else if(!instance.solved && instance.stats.spill_failed){reply.put("error a spill file failed\n");}
+    else if(!instance.solved){reply.put("no solution\n");}
+    else{create_compact_output(reply, instance.depth, instance.stats.nodes_generated, instance.actions, instance.fvalues);}
+
+} // end of answer_serve_request function definition
+
+
+static string answer_serve_line(const string& line, serve_state& shared, serve_worker& worker){ // start of answer_serve_line function definition
+    
+    /* the reply to one request line --- the board size comes from how many numbers it holds */
+
+    board_reader request;
+    request.open_memory(line.data(), line.size());
+    int value;
+    while(request.scan(value)){request.pending.push_back(value);}
+
+    output_writer reply(-1, 256);
+    if(request.malformed){reply.put("error "); reply.put(request.error.c_str()); reply.put('\n'); return reply.text();}
+
+    switch(request.pending.size()){
+        case 2 * 3 * 3: answer_serve_request<3>(request, shared, worker, reply); break;
+        case 2 * 4 * 4: answer_serve_request<4>(request, shared, worker, reply); break;
+        case 2 * 5 * 5: answer_serve_request<5>(request, shared, worker, reply); break;
+        default:
+            reply.put("error Expected 18, 32 or 50 numbers (start board then goal board), got ");
+            reply.put(static_cast<long long>(request.pending.size()));
+            reply.put(".\n");
+    }
+    return reply.text();
+
+} // end of answer_serve_line function definition
+
+
+static void serve_worker_loop(serve_state& shared){ // start of serve_worker_loop function definition
+    
+    /* one solver thread: takes requests off the queue until the daemon stops, hands the replies back to the event loop */
+
+    serve_worker worker;
+    while(true){
+
+        serve_job job;
+        {
+            unique_lock<mutex> guard(shared.jobs_lock);
+            shared.jobs_ready.wait(guard, [&](){return shared.stopping || !shared.jobs.empty();});
+            if(shared.stopping){return;} // requests still queued are dropped --- their connections are being closed anyway
+            job = move(shared.jobs.front());
+            shared.jobs.pop_front();
+        }
+
+        string text = answer_serve_line(job.request, shared, worker);
+        {
+            lock_guard<mutex> guard(shared.replies_lock);
+            shared.replies.push_back({job.connection, job.sequence, move(text)});
+        }
+        if(!shared.wake_pending.exchange(true)){
+            uint64_t one = 1;
+            while(write(shared.wake_fd, &one, sizeof(one)) < 0 && errno == EINTR){}
+        }
+
+    }
+
+} // end of serve_worker_loop function definition
+
+
+struct serve_connection{ // start of serve_connection struct definition
+
+    /* one client of the event loop */
+
+    int fd;
+    string input;                    // bytes received but not yet split into request lines
+    uint64_t next_sequence = 0;      // sequence number the next request line gets
+    uint64_t next_to_send = 0;       // sequence number of the next reply to go out --- replies leave in request order
+    map<uint64_t, string> early;     // replies that finished ahead of an earlier request on the same connection
+    string output;                   // in-order replies not yet written
+    size_t output_sent = 0;
+    bool input_closed = false;       // the client has shut its sending side (or sent something unusable)
+    uint32_t interest = 0;           // epoll events currently registered
+
+}; // end of serve_connection struct definition
+
+
+static int open_serve_socket(const string& socket_path){ // start of open_serve_socket function definition
+    
+    /* binds and listens on the Unix socket --- a socket file left behind by a daemon that is no longer running is replaced, a live one is not */
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if(socket_path.size() >= sizeof(address.sun_path)){cerr << "The socket path is too long." << endl; return -1;}
+    memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    struct stat file_info;
+    if(stat(socket_path.c_str(), &file_info) == 0 && S_ISSOCK(file_info.st_mode)){
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool live = probe >= 0 && connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        if(probe >= 0){close(probe);}
+        if(live){cerr << "Another daemon is already listening on " << socket_path << "." << endl; return -1;}
+        unlink(socket_path.c_str());
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0){
+        cerr << "Failed to listen on " << socket_path << ": " << strerror(errno) << endl;
+        if(listener >= 0){close(listener);}
+        return -1;
+    }
+    return listener;
+
+} // end of open_serve_socket function definition
+
+
+static int run_daemon(const string& socket_path, const solver_options& options){ // start of run_daemon function definition
+    
+    /*
+       the event loop (see the top of this section)
+       epoll data tags: 0 the listening socket, 1 the workers' eventfd, 2 the signalfd, anything above a connection id
+    */
+
+    const uint64_t LISTENER_TAG = 0, WAKE_TAG = 1, SIGNAL_TAG = 2;
+
+    // SIGINT/SIGTERM arrive through a signalfd --- blocked before the workers start, so only the loop ever sees them
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+    signal(SIGPIPE, SIG_IGN); // a client that hangs up mid-reply is an error return from send, not a dead daemon
+
+    int listener = open_serve_socket(socket_path);
+    if(listener < 0){return 1;}
+
+    serve_state shared;
+    shared.options = &options;
+    shared.cache_3.capacity = shared.cache_4.capacity = shared.cache_5.capacity = options.cache_capacity;
+    shared.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int signal_fd = signalfd(-1, &stop_signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    int loop_fd = epoll_create1(EPOLL_CLOEXEC);
+    if(shared.wake_fd < 0 || signal_fd < 0 || loop_fd < 0){cerr << "Failed to set up the event loop: " << strerror(errno) << endl; unlink(socket_path.c_str()); return 1;}
+
+    auto watch = [&](int fd, uint32_t events, uint64_t tag, int operation){
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = tag;
+        return epoll_ctl(loop_fd, operation, fd, &event) == 0;
+    };
+    watch(listener, EPOLLIN, LISTENER_TAG, EPOLL_CTL_ADD);
+    watch(shared.wake_fd, EPOLLIN, WAKE_TAG, EPOLL_CTL_ADD);
+    watch(signal_fd, EPOLLIN, SIGNAL_TAG, EPOLL_CTL_ADD);
+
+    vector<thread> workers;
+    for(int each_worker = 0; each_worker < options.thread_count; ++each_worker){workers.emplace_back(serve_worker_loop, ref(shared));}
+    cerr << "serving on " << socket_path << " with " << options.thread_count << " solver thread" << (options.thread_count == 1 ? "" : "s") << endl;
+
+    unordered_map<uint64_t, serve_connection> connections;
+    uint64_t next_connection = SIGNAL_TAG + 1;
+
+    auto close_connection = [&](uint64_t id){
+        auto found = connections.find(id);
+        if(found == connections.end()){return;}
+        close(found->second.fd); // also drops it from the epoll set
+        connections.erase(found);
+    };
+
+    // writes what it can of the connection's in-order replies, keeps epoll interest in step, and closes it once it is finished
+    auto pump = [&](uint64_t id){
+        serve_connection& connection = connections.at(id);
+        while(connection.output_sent < connection.output.size()){
+            ssize_t sent = send(connection.fd, connection.output.data() + connection.output_sent, connection.output.size() - connection.output_sent, MSG_NOSIGNAL);
+            if(sent < 0 && errno == EINTR){continue;}
+            if(sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){break;}
+            if(sent <= 0){close_connection(id); return;}
+            connection.output_sent += static_cast<size_t>(sent);
+        }
+        if(connection.output_sent == connection.output.size()){connection.output.clear(); connection.output_sent = 0;}
+
+        bool replies_owed = connection.next_to_send < connection.next_sequence;
+        if(connection.input_closed && !replies_owed && connection.output.empty()){close_connection(id); return;}
+
+        uint32_t interest = (connection.input_closed ? 0u : uint32_t(EPOLLIN)) | (connection.output.empty() ? 0u : uint32_t(EPOLLOUT));
+        if(interest != connection.interest){watch(connection.fd, interest, id, EPOLL_CTL_MOD); connection.interest = interest;}
+    };
+
+    // splits the connection's input into request lines and queues them
+    auto queue_requests = [&](uint64_t id){
+        serve_connection& connection = connections.at(id);
+        size_t line_start = 0, line_end;
+        int queued = 0;
+        {
+            lock_guard<mutex> guard(shared.jobs_lock);
+            while((line_end = connection.input.find('\n', line_start)) != string::npos){
+                string line = connection.input.substr(line_start, line_end - line_start);
+                line_start = line_end + 1;
+                if(line.find_first_not_of(" \t\r") == string::npos){continue;} // blank line
+                shared.jobs.push_back({id, connection.next_sequence++, move(line)});
+                ++queued;
+            }
+        }
+        connection.input.erase(0, line_start);
+        if(queued == 1){shared.jobs_ready.notify_one();}
+        else if(queued > 1){shared.jobs_ready.notify_all();}
+
+        if(connection.input.size() > SERVE_MAX_LINE){ // no newline in sight --- not a client of this protocol
+            connection.output += "error Request line too long.\n";
+            connection.input.clear();
+            connection.input_closed = true;
+            connection.next_to_send = connection.next_sequence; // nothing after this is answered
+        }
+    };
+
+    // hands finished replies to their connections, in request order
+    auto deliver_replies = [&](){
+        uint64_t counter;
+        while(read(shared.wake_fd, &counter, sizeof(counter)) < 0 && errno == EINTR){}
+        shared.wake_pending.store(false);
+
+        vector<serve_reply> finished;
+        {
+            lock_guard<mutex> guard(shared.replies_lock);
+            finished.swap(shared.replies);
+        }
+
+        vector<uint64_t> touched;
+        for(serve_reply& reply : finished){
+            auto found = connections.find(reply.connection);
+            if(found == connections.end()){continue;} // the client is gone
+            serve_connection& connection = found->second;
+            if(reply.sequence < connection.next_to_send){continue;} // given up on (see the line-too-long case)
+
+            connection.early.emplace(reply.sequence, move(reply.text));
+            while(!connection.early.empty() && connection.early.begin()->first == connection.next_to_send){
+                connection.output += connection.early.begin()->second;
+                connection.early.erase(connection.early.begin());
+                ++connection.next_to_send;
+            }
+            touched.push_back(reply.connection);
+        }
+        sort(touched.begin(), touched.end());
+        touched.erase(unique(touched.begin(), touched.end()), touched.end());
+        for(uint64_t id : touched){pump(id);}
+    };
+
+    const int MAX_EVENTS = 64;
+    epoll_event events[MAX_EVENTS];
+    bool running = true;
+    while(running){ // start of the event loop
+
+        int ready = epoll_wait(loop_fd, events, MAX_EVENTS, -1);
+        if(ready < 0){
+            if(errno == EINTR){continue;}
+            cerr << "epoll_wait failed: " << strerror(errno) << endl;
+            break;
+        }
+
+        for(int each_event = 0; each_event < ready; ++each_event){
+
+            uint64_t tag = events[each_event].data.u64;
+            uint32_t happened = events[each_event].events;
+
+            if(tag == SIGNAL_TAG){running = false; break;}
+            if(tag == WAKE_TAG){deliver_replies(); continue;}
+
+            if(tag == LISTENER_TAG){
+                while(true){
+                    int client = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if(client < 0){break;} // EAGAIN once the backlog is drained (anything else: try again on the next event)
+                    uint64_t id = next_connection++;
+                    serve_connection& connection = connections[id];
+                    connection.fd = client;
+                    connection.interest = EPOLLIN;
+                    if(!watch(client, EPOLLIN, id, EPOLL_CTL_ADD)){close_connection(id);}
+                }
+                continue;
+            }
+
+            if(connections.find(tag) == connections.end()){continue;} // closed earlier in this round
+            serve_connection& connection = connections.at(tag);
+
+            if(happened & (EPOLLERR | EPOLLHUP)){close_connection(tag); continue;} // the client is gone for good --- nobody left to answer
+
+            if(happened & EPOLLIN){
+                char received[16384];
+                while(true){
+                    ssize_t count = read(connection.fd, received, sizeof(received));
+                    if(count > 0){connection.input.append(received, static_cast<size_t>(count)); continue;}
+                    if(count < 0 && errno == EINTR){continue;}
+                    if(count == 0){connection.input_closed = true;} // half-close: answer what was asked, then hang up
+                    else if(errno != EAGAIN && errno != EWOULDBLOCK){connection.input_closed = true;}
+                    break;
+                }
+                if(connection.input_closed && !connection.input.empty()){connection.input += '\n';} // a last request without its newline
+                queue_requests(tag);
+            }
+            pump(tag);
+
+        }
+
+    } // end of the event loop
+
+    {
+        lock_guard<mutex> guard(shared.jobs_lock);
+        shared.stopping = true;
+    }
+    shared.jobs_ready.notify_all();
+    for(thread& each_worker : workers){each_worker.join();}
+
+    for(auto& [id, connection] : connections){close(connection.fd);}
+    close(listener);
+    close(loop_fd);
+    close(signal_fd);
+    close(shared.wake_fd);
+    unlink(socket_path.c_str());
+    cerr << "daemon stopped" << endl;
     return 0;
 
+} // end of run_daemon function definition
+
+
+static int run_for_board_size(board_reader& reader, const solver_options& options, bool batch){ // start of run_for_board_size function definition
+    
+    /* reads the board size off the first row of the input and runs the mode with the matching compiled instantiation (3x3, 4x4 or 5x5) */
+
+    int board_size = detect_board_size(reader);
+    if(reader.malformed){cerr << reader.error << endl; return 1;}
+    if(board_size < MIN_BOARD_SIZE || board_size > MAX_BOARD_SIZE){
+        cerr << "Unsupported board size " << board_size << ". Boards must be " << MIN_BOARD_SIZE << "x" << MIN_BOARD_SIZE << " to " << MAX_BOARD_SIZE << "x" << MAX_BOARD_SIZE << "." << endl;
+        return 1;
+    }
+    if((options.heuristic_choice == 3 || options.search_choice == SEARCH_ORACLE) && board_size * board_size != PDB_CELLS){cerr << "The pattern database (h3 and --search=oracle) only covers 3x3 boards." << endl; return 1;}
+
+    switch(board_size){
+        case 3: return batch ? run_batch<3>(reader, options) : run_single<3>(reader, options);
+        case 4: return batch ? run_batch<4>(reader, options) : run_single<4>(reader, options);
+        default: return batch ? run_batch<5>(reader, options) : run_single<5>(reader, options);
+    }
+
+} // end of run_for_board_size function definition
+
+
+
+
+
+
+int main(int argc, char* argv[]){ // start of main function
+                                      // WHERE ALL THE ACTION OCCURS
+
+    // checking correct command line arguments
+        // the source code
+        // the input file (3x3, 4x4 or 5x5 boards --- the size is read off the first row)
+        // the heuristic choice (1, 2 or 3 --- 3 is for 3x3 boards only)
+        // optional flags after those two:
+        //    --search=astar|ida|bidir|oracle|hda search engine (default astar --- bidir is MM bidirectional search, oracle walks the pattern database,
+        //                             hda is parallel A* over --threads=<count> threads)
+        //    --frontier=heap|bucket   open list used by A* (default heap)
+        //    --pdb=<file>             pattern database used by h3 and the oracle (default eight_puzzle.pdb)
+        //    --cache=<entries>        keep up to this many solved queries in an LRU result cache (also answers the reversed query)
+        //    --cache-file=<file>      load the result cache from this file at startup and save it back on exit
+        //    --trace=text|json        print what the solve spent its work on after the output (hot-path detail needs -DSOLVER_TRACE)
+        //    --memory=<bytes>[K|M|G]  A* keeps its tables within this budget (at least 4M), spilling the frontier to disk past it
+        //    --spill-dir=<dir>        where --memory writes its spill files (default $TMPDIR, else /tmp)
+    // or, to solve many puzzles in one process:  --batch <file, or - for stdin> <heuristic choice> [flags] [--compact] [--threads=<count, 0 for one per core>]
+    // or, to answer queries from other processes: --serve <socket path> <heuristic choice> [flags] [--threads=<solver threads, 0 for one per core>]
+    // or, to build the pattern database once:    --build-pdb <file>
+    // or, to time the solver:                      --bench <3|4|5 to generate a suite, or a suite file> [--seed=<n>] [--per-depth=<n>] [--max-depth=<n>] [--save-suite=<file>]
+    //                                                 [--format=csv|json] [--pdb=<file>] [--heuristics=1,2,3] [--engines=astar-heap,astar-bucket,ida,bidir,oracle,hda,astar-memory]
+    //                                                 [--threads=<hda threads, default 4>] [--memory=<astar-memory budget, default 64M>] [--spill-dir=<dir>]
+    if(argc == 3 && string(argv[1]) == "--build-pdb"){
+        return build_pattern_database(argv[2]) ? 0 : 1;
+    }
+
+    if(argc >= 3 && string(argv[1]) == "--bench"){ // BENCHMARK MODE
+        benchmark_options bench;
+        if(!parse_benchmark_options(argc, argv, bench)){return 1;}
+        return run_benchmark_for_board_size(bench);
+    }
+
+    solver_options options;
+
+    if(argc >= 4 && string(argv[1]) == "--serve"){ // DAEMON MODE
+        if(!parse_options(argc, argv, 4, argv[3], options)){return 1;}
+        if(options.trace_output != TRACE_OFF || options.compact_output){cerr << "--trace and --compact do not apply to --serve (replies are always one line)." << endl; return 1;}
+        if(options.search_choice == SEARCH_HDA_STAR){cerr << "--search=hda parallelizes a single puzzle --- the daemon runs requests in parallel with --threads already." << endl; return 1;}
+        if(!options.cache_file.empty()){cerr << "--cache-file does not apply to --serve --- the daemon's --cache stays warm for as long as it runs." << endl; return 1;}
+        return run_daemon(argv[2], options);
+    }
+
+    if(argc >= 4 && string(argv[1]) == "--batch"){ // BATCH MODE
+        if(!parse_options(argc, argv, 4, argv[3], options)){return 1;}
+        if(options.trace_output != TRACE_OFF){cerr << "--trace only applies to a single puzzle." << endl; return 1;}
+        if(options.search_choice == SEARCH_HDA_STAR){cerr << "--search=hda parallelizes a single puzzle --- batches run in parallel with --threads already." << endl; return 1;}
+
+        string batch_file = argv[2];
+        board_reader batch_input;
+        bool opened = (batch_file == "-") ? batch_input.open_descriptor(STDIN_FILENO) : batch_input.open_file(batch_file);
+        if(!opened){cerr << "Failed to open the batch input file. Please retry." << endl; return 1;}
+        return run_for_board_size(batch_input, options, true);
+    }
+
+    if(argc < 3){
+        cerr << "Wrong number of arguments. Please enter the input file and the heuristic choice." << endl;
+        return 1;
+    }
+
+
+    // grab the command line arguments
+       // there should be two arguments: the input file and the heuristic choice
+    string input_file = argv[1];
+    if(!parse_options(argc, argv, 3, argv[2], options)){return 1;}
+    if(options.compact_output){cerr << "--compact only applies to --batch." << endl; return 1;}
+    if(options.thread_count != 1 && options.search_choice != SEARCH_HDA_STAR){cerr << "--threads only applies to --batch and --search=hda." << endl; return 1;}
+
+    board_reader input; // open the input file
+    if(!input.open_file(input_file)){cerr << "Failed to open the input file. Please retry." << endl; return 1;}
+
+    return run_for_board_size(input, options, false); // the board size (3x3, 4x4 or 5x5) comes from the file
+
 
 } // end of main function
 